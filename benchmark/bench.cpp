@@ -0,0 +1,649 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+// g++ -I include -m64 -std=c++26 -Wall -O3 -o /tmp/bench benchmark/bench.cpp
+
+// usage: bench [--json file] [--filter name]
+// runs the microbenchmarks and reports ns/op, bytes/s and allocations/op of each case,
+// the results are written as json to the file given by --json ('-' for stdout, the table goes to stderr then)
+
+#include <map>
+#include <set>
+#include <list>
+#include <array>
+#include <deque>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <forward_list>
+#include <unordered_map>
+#include <unordered_set>
+#include <fmp.hpp>
+#include <version.hpp>
+#include <decoder.hpp>
+#include <thread>
+#include <rpc.hpp>
+#include <tracked.hpp>
+#include <registry.hpp>
+#include <compress.hpp>
+
+#if __has_include(<flat_map>)
+#include <flat_map>
+#endif
+
+// count every allocation made through the global operator new
+
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+namespace bench
+{
+    inline std::atomic<size_t> allocations = 0;
+}
+
+void* operator new(size_t size)
+{
+    bench::allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace bench
+{
+    using clock = std::chrono::steady_clock;
+
+    struct result
+    {
+        std::string name;
+        size_t iterations;
+        double ns;
+        double bytes;
+        double allocations;
+    };
+
+    template <typename T>
+    inline void escape(T&& t)
+    {
+        asm volatile("" : : "g"(std::addressof(t)) : "memory");
+    }
+
+    template <typename F>
+    result run(const std::string& name, size_t bytes, F&& f)
+    {
+        using namespace std::chrono_literals;
+
+        size_t n = 1;
+        clock::duration elapsed;
+
+        size_t a = 0;
+
+        while (true)
+        {
+            a = allocations.load(std::memory_order_relaxed);
+            auto start = clock::now();
+
+            for (size_t i = 0; i != n; ++i)
+                 f();
+
+            elapsed = clock::now() - start;
+            a = allocations.load(std::memory_order_relaxed) - a;
+
+            if (elapsed >= 200ms || n >= (size_t(1) << 30))
+                break;
+
+            n *= elapsed < 20ms ? 10 : 2;
+        }
+
+        double ns = std::chrono::duration<double, std::nano>(elapsed).count() / n;
+
+        return { name, n, ns, bytes * 1e9 / ns, double(a) / n };
+    }
+
+    struct suite
+    {
+        std::string filter;
+        std::vector<result> results;
+
+        std::ostream* out = &std::cout;
+
+        template <typename F>
+        void add(const std::string& name, size_t bytes, F&& f)
+        {
+            if (name.find(filter) == std::string::npos)
+                return;
+
+            auto& r = results.emplace_back(run(name, bytes, std::forward<F>(f)));
+
+            *out << std::left << std::setw(28) << r.name << std::right
+                      << std::setw(14) << std::fixed << std::setprecision(1) << r.ns << " ns/op"
+                      << std::setw(14) << std::setprecision(1) << r.bytes / (1 << 20) << " MiB/s"
+                      << std::setw(12) << std::setprecision(2) << r.allocations << " allocs/op" << std::endl;
+        }
+
+        void json(std::ostream& os) const
+        {
+            os << std::fixed << std::setprecision(3);
+            os << "{\n  \"version\": \"fmp/" << FMP_VERSION_NUMBER << "\",\n  \"results\": [";
+
+            for (const char* sep = "\n"; auto& r : results)
+            {
+                 os << sep << "    { \"name\": " << std::quoted(r.name) << ", \"iterations\": " << r.iterations
+                    << ", \"ns_per_op\": " << r.ns << ", \"bytes_per_second\": " << r.bytes
+                    << ", \"allocations_per_op\": " << r.allocations << " }";
+
+                 sep = ",\n";
+            }
+
+            os << "\n  ]\n}" << std::endl;
+        }
+    };
+}
+
+// flat structure of fundamentals
+
+struct P
+{
+    int i;
+    long l;
+    double d;
+    float f;
+    char c;
+    bool b;
+    short s;
+};
+
+// string heavy structure
+
+struct W
+{
+    int rank;
+    std::string key;
+    std::string val;
+};
+
+struct X
+{
+    float f;
+    std::string s;
+};
+
+// deeply nested structure with all kinds of STL containers
+
+struct Z
+{
+    int i;
+    double d;
+    char c;
+    X x;
+    X* ptr;
+    std::string s;
+    std::list<int> ages;
+    std::deque<std::string> names;
+    std::vector<X> xs;
+    std::forward_list<std::vector<int>> ints;
+    std::shared_ptr<X> sp;
+    std::array<X, 3> arrs;
+    std::set<int> sets;
+    std::map<int, std::string> maps;
+    std::multiset<int> multisets;
+    std::multimap<int, std::string> multimaps;
+    std::unordered_set<int> unordered_sets;
+    std::unordered_map<int, std::string> unordered_maps;
+    std::unordered_multiset<int> unordered_multisets;
+    std::unordered_multimap<int, std::string> unordered_multimaps;
+};
+
+// large containers
+
+struct L
+{
+    std::vector<double> values;
+    std::vector<W> rows;
+    std::map<int, std::string> index;
+};
+
+// routing table, a large sorted map
+
+struct R
+{
+    std::map<int, int> routes;
+};
+
+#ifdef __cpp_lib_flat_map
+struct F
+{
+    std::flat_map<int, int> routes;
+};
+#endif
+
+template <typename T>
+void codec(bench::suite& s, const std::string& name, const T& t)
+{
+    std::string buff = fmp::marshal(t);
+    size_t size = buff.size();
+
+    s.add(name + "/size_bytes", size, [&]
+    {
+        size_t n = fmp::size_bytes(t);
+        bench::escape(n);
+    });
+
+    s.add(name + "/marshal", size, [&]
+    {
+        std::string b = fmp::marshal(t);
+        bench::escape(b);
+    });
+
+    s.add(name + "/marshal_reuse", size, [&]
+    {
+        buff.clear();
+
+        fmp::marshal(buff, t);
+        bench::escape(buff);
+    });
+
+    s.add(name + "/unmarshal", size, [&]
+    {
+        T r = fmp::unmarshal<T>(buff);
+        bench::escape(r);
+
+        if constexpr(requires { r.ptr; })
+            delete r.ptr;
+    });
+
+    T u {};
+    fmp::unmarshal(buff, u, fmp::reuse());
+
+    s.add(name + "/unmarshal_reuse", size, [&]
+    {
+        fmp::unmarshal(buff, u, fmp::reuse());
+        bench::escape(u);
+    });
+
+    std::string big = fmp::marshal(t, fmp::big_endian());
+
+    s.add(name + "/marshal_big_endian", size, [&]
+    {
+        buff.clear();
+
+        fmp::marshal(buff, t, fmp::big_endian());
+        bench::escape(buff);
+    });
+
+    s.add(name + "/unmarshal_big_endian", size, [&]
+    {
+        fmp::unmarshal(big, u, fmp::policies<fmp::reuse, fmp::big_endian>());
+        bench::escape(u);
+    });
+
+    std::string framed = fmp::marshal(t, fmp::framed());
+
+    s.add(name + "/marshal_framed", framed.size(), [&]
+    {
+        buff.clear();
+
+        fmp::marshal(buff, t, fmp::framed());
+        bench::escape(buff);
+    });
+
+    s.add(name + "/unmarshal_framed", framed.size(), [&]
+    {
+        fmp::unmarshal(framed, u, fmp::policies<fmp::reuse, fmp::framed>());
+        bench::escape(u);
+    });
+
+    if constexpr(requires { u.ptr; })
+        delete u.ptr;
+
+    std::string tagged = fmp::marshal(t, fmp::tagged());
+
+    s.add(name + "/marshal_tagged", tagged.size(), [&]
+    {
+        std::string b = fmp::marshal(t, fmp::tagged());
+        bench::escape(b);
+    });
+
+    s.add(name + "/unmarshal_tagged", tagged.size(), [&]
+    {
+        T r = fmp::unmarshal<T>(tagged, fmp::tagged());
+        bench::escape(r);
+
+        if constexpr(requires { r.ptr; })
+            delete r.ptr;
+    });
+
+    s.add(name + "/tie_fuple", sizeof(T), [&]
+    {
+        auto f = fmp::tie_fuple(t);
+        bench::escape(f);
+    });
+}
+
+void checksum(bench::suite& s, const std::string& name, size_t size)
+{
+    std::string b(size, 0);
+
+    for (size_t i = 0; i != size; ++i)
+         b[i] = char(i * 7);
+
+    s.add(name + "/crc32c", size, [&]
+    {
+        uint32_t crc = fmp::crc32c(b.data(), b.size());
+        bench::escape(crc);
+    });
+}
+
+template <typename T>
+void lz(bench::suite& s, const std::string& name, const T& t)
+{
+    std::string b = fmp::marshal(t);
+
+    std::string c(fmp::compress_bound(b.size()), 0);
+    std::string d(b.size(), 0);
+
+    size_t size = fmp::compress(b.data(), b.size(), c.data());
+
+    s.add(name + "/lz_compress", b.size(), [&]
+    {
+        size_t n = fmp::compress(b.data(), b.size(), c.data());
+        bench::escape(n);
+    });
+
+    s.add(name + "/lz_decompress", b.size(), [&]
+    {
+        size_t n = fmp::decompress(c.data(), size, d.data(), d.size());
+        bench::escape(n);
+    });
+}
+
+// a message arriving in segments of a tcp packet
+
+template <typename T>
+void stream(bench::suite& s, const std::string& name, const T& t)
+{
+    std::string b = fmp::marshal(t);
+
+    T u {};
+    fmp::unmarshal(b, u, fmp::reuse());
+
+    fmp::decoder d(u, fmp::reuse());
+
+    s.add(name + "/decoder_1460", b.size(), [&]
+    {
+        d.start(u);
+
+        for (size_t i = 0; i < b.size(); i += 1460)
+             d.feed(b.data() + i, std::min<size_t>(1460, b.size() - i));
+
+        bench::escape(u);
+    });
+
+    if constexpr(requires { u.ptr; })
+        delete u.ptr;
+}
+
+// pipelined round trips over a socketpair, a batch of 256 requests per op
+
+template <typename T>
+T echo(const T& t)
+{
+    return t;
+}
+
+template <typename T>
+void rpc(bench::suite& s, const std::string& name, const T& t)
+{
+    auto [a, b] = fmp::rpc::pair();
+
+    std::thread server([fd = b]
+    {
+        fmp::rpc::server<T, T> s(fd);
+
+        s.template bind<echo<T>>();
+        s.run();
+    });
+
+    {
+        fmp::rpc::client<T, T> c(a);
+        T r {};
+
+        s.add(name + "/rpc_pipelined", 256 * fmp::size_bytes(t), [&]
+        {
+            for (size_t i = 0; i != 256; ++i)
+                 c.template send<echo<T>>(t);
+
+            c.flush();
+
+            uint64_t id;
+
+            for (size_t i = 0; i != 256; ++i)
+                 c.recv(id, r);
+
+            bench::escape(r);
+        });
+    }
+
+    server.join();
+}
+
+// a message of a mixed stream, decoded through the jump table of its type id
+
+template <typename... Ts, typename T>
+void dispatch(bench::suite& s, const std::string& name, const T& t)
+{
+    using messages = fmp::registry<Ts...>;
+
+    std::string b = messages::marshal(t);
+    typename messages::variant v;
+
+    s.add(name + "/registry_decode", b.size(), [&]
+    {
+        size_t l = 0;
+
+        messages::decode(l, b, v);
+        bench::escape(v);
+    });
+}
+
+// one member of a large record changed, diffed against a copy or tracked
+
+template <typename T>
+void delta(bench::suite& s, const std::string& name, const T& t)
+{
+    T u = t;
+    fmp::get<0>(u) += 1;
+
+    fmp::tracked<T> v(t);
+    fmp::get<0>(v) = fmp::get<0>(u);
+
+    std::string b;
+
+    s.add(name + "/diff", sizeof(T), [&]
+    {
+        b.clear();
+
+        fmp::diff(b, t, u);
+        bench::escape(b);
+    });
+
+    s.add(name + "/marshal_dirty", sizeof(T), [&]
+    {
+        b.clear();
+
+        v.marshal_dirty(b);
+        bench::escape(b);
+    });
+}
+
+template <typename T>
+void compare(bench::suite& s, const std::string& name, const T& t, const T& u)
+{
+    s.add(name + "/eq", sizeof(T), [&]
+    {
+        bool b = fmp::eq(t, u);
+        bench::escape(b);
+    });
+
+    s.add(name + "/lt", sizeof(T), [&]
+    {
+        bool b = fmp::lt(t, u);
+        bench::escape(b);
+    });
+}
+
+template <typename T>
+void io(bench::suite& s, const std::string& name, const T& t)
+{
+    std::ostringstream os;
+    os << fmp::io(t);
+
+    std::string text = os.str();
+
+    s.add(name + "/io_out", text.size(), [&]
+    {
+        std::ostringstream os;
+        os << fmp::io(t);
+
+        bench::escape(os);
+    });
+
+    s.add(name + "/io_in", text.size(), [&]
+    {
+        T r;
+        std::istringstream is(text);
+
+        is >> fmp::io(r);
+        bench::escape(r);
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    bench::suite s;
+    std::string json;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+         std::string_view arg = argv[i];
+
+         if (arg == "--json")
+             json = argv[i + 1];
+         else if (arg == "--filter")
+             s.filter = argv[i + 1];
+    }
+
+    if (json == "-")
+        s.out = &std::cerr;
+
+    P p { 2024, 1L << 40, 11.05, 3.14f, 'P', true, 512 };
+    P q { 2024, 1L << 40, 11.05, 3.14f, 'Q', true, 512 };
+
+    W w { 100, "Modern C++ Template", "MetaProgramming Library" };
+    W v { 100, "Modern C++ Template", "MetaProgramming Framework" };
+
+    X x { 53.86f, "reflect" };
+
+    std::vector<int> v1 { 0, 1, 2, 3 };
+    std::vector<int> v2 { 4, 5, 6, 7, 8 };
+
+    Z z { 18, 9.87, '*', x, &x, "TMP", { 1, 3, 6 }, { "fmp", "C++", "template" }, { x, x, x }, { v1, v2 },
+          std::make_shared<X>(15.18f, "reflect"), { x, x, x }, { 3, 2, 5 }, { { 2, "two" }, { 1, "one" } },
+          { 3, 2, 2, 5 }, { { 4, "four" }, { 4, "four2" } }, { 3, 2, 5 }, { { 2, "two" }, { 5, "five" } },
+          { 4, 3, 3 }, { { 5, "two" }, { 2, "one" } } };
+
+    L l;
+
+    for (int i = 0; i != 1 << 16; ++i)
+         l.values.push_back(i * 0.5);
+
+    for (int i = 0; i != 1 << 10; ++i)
+         l.rows.push_back({ i, "key" + std::to_string(i), "value" + std::to_string(i) });
+
+    for (int i = 0; i != 1 << 12; ++i)
+         l.index.emplace(i, "index" + std::to_string(i));
+
+    R r;
+
+    for (int i = 0; i != 1 << 20; ++i)
+         r.routes.emplace_hint(r.routes.end(), i, i ^ 0x5a5a);
+
+    codec(s, "P", p);
+    codec(s, "W", w);
+    codec(s, "Z", z);
+    codec(s, "L", l);
+    codec(s, "R", r);
+
+#ifdef __cpp_lib_flat_map
+    F f { { std::sorted_unique, r.routes.begin(), r.routes.end() } };
+
+    codec(s, "F", f);
+#endif
+
+    checksum(s, "1M", 1 << 20);
+
+    lz(s, "L", l);
+    lz(s, "rows", l.rows);
+
+    rpc(s, "P", p);
+    rpc(s, "W", w);
+
+    dispatch<P, W, X, L>(s, "P", p);
+    dispatch<P, W, X, L>(s, "W", w);
+
+    stream(s, "Z", z);
+    stream(s, "L", l);
+
+    delta(s, "Z", z);
+
+    compare(s, "P", p, q);
+    compare(s, "W", w, v);
+
+    io(s, "P", p);
+    io(s, "W", w);
+
+    if (json == "-")
+        s.json(std::cout);
+    else if (!json.empty())
+    {
+        std::ofstream os(json);
+        s.json(os);
+    }
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+// benchmark/compile_time.sh generates the synthetic structure S with N fields, defines
+// FMP_BENCH_TYPES (the member types of S) and FMP_BENCH_MPTRS (the member pointers of S),
+// and compiles this translation unit once per public api with -DFMP_BENCH_<API>
+
+#include <string>
+#include <sstream>
+#include <fmp.hpp>
+
+using fuple_t = fmp::fuple<FMP_BENCH_TYPES>;
+using tuple_t = std::tuple<FMP_BENCH_TYPES>;
+
+inline constexpr size_t fields = fmp::fuple_size_v<fuple_t>;
+
+// the N-th of 16 inputs of 16 elements each for the concatenations, of distinct types
+
+template <size_t N, template <typename ...> typename T, typename = std::make_index_sequence<16>>
+struct input;
+
+template <size_t N, template <typename ...> typename T, size_t... K>
+struct input<N, T, std::index_sequence<K...>>
+{
+    using type = T<std::integral_constant<size_t, N * 16 + K>...>;
+};
+
+template <size_t N, template <typename ...> typename T>
+using input_t = typename input<N, T>::type;
+
+auto sink = []<typename... Args>(Args&&... args)
+{
+    return sizeof...(Args);
+};
+
+int main(int argc, char* argv[])
+{
+    size_t n = 0;
+
+#if defined(FMP_BENCH_FUPLE)
+    fuple_t f;
+    fuple_t g = f;
+
+    n += fmp::apply(sink, g);
+    n += sizeof(fmp::get<fields - 1>(f));
+#elif defined(FMP_BENCH_FUPLE_CAT)
+    fuple_t f;
+    fuple_t g;
+
+    n += fmp::fuple_size_v<decltype(fmp::fuple_cat(f, g))>;
+#elif defined(FMP_BENCH_TUPLE_CAT)
+    tuple_t t;
+    tuple_t u;
+
+    n += std::tuple_size_v<decltype(fmp::tuple_cat(t, u))>;
+#elif defined(FMP_BENCH_FUPLE_CAT_16X16)
+    n += []<size_t... N>(std::index_sequence<N...>)
+    {
+        return fmp::fuple_size_v<decltype(fmp::fuple_cat(std::declval<input_t<N, fmp::fuple>&>()...))>;
+    }
+    (std::make_index_sequence<16>());
+#elif defined(FMP_BENCH_TUPLE_CAT_16X16)
+    n += []<size_t... N>(std::index_sequence<N...>)
+    {
+        return std::tuple_size_v<decltype(fmp::tuple_cat(std::declval<input_t<N, std::tuple>&>()...))>;
+    }
+    (std::make_index_sequence<16>());
+#elif defined(FMP_BENCH_ZIP)
+    fuple_t f;
+    fuple_t g;
+
+    fmp::zip(sink, f, g);
+#elif defined(FMP_BENCH_COMPARE)
+    fuple_t f;
+    fuple_t g;
+
+    n += (f < g) + (f == g);
+#elif defined(FMP_BENCH_INDEX)
+    fuple_t f;
+
+    n += fmp::fuple_index<short>(f) + sizeof(fmp::get<long>(f));
+#elif defined(FMP_BENCH_IO)
+    S s {};
+    std::stringstream ss;
+
+    ss << fmp::io(s);
+    ss >> fmp::io(s);
+
+    n += ss.str().size();
+#elif defined(FMP_BENCH_MEMBER_NAMES)
+    constexpr auto names = fmp::member_names_v<S>;
+
+    n += fmp::get<fields - 1>(names).size();
+#elif defined(FMP_BENCH_MEMBER_STEM)
+    n += []<auto... m>()
+    {
+        return (... + fmp::member_stem<m>().size());
+    }
+    .template operator()<FMP_BENCH_MPTRS>();
+#endif
+
+    return n == size_t(argc);
+}
@@ -0,0 +1,116 @@
+#!/bin/bash
+#
+# Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+#
+# Distributed under the Boost Software License, Version 1.0.
+# (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+#
+# Official repository: https://github.com/deepgrace/fmp
+#
+
+# usage: benchmark/compile_time.sh [compiler] [output directory]
+# measures the compile time and the peak memory of the compiler for every public api
+# against synthetic structures, extra flags can be passed with the CXXFLAGS variable
+
+cxx=${1:-g++}
+dst=${2:-/tmp}
+
+cd $(dirname $0)/..
+
+path=benchmark
+json=${dst}/compile_time.json
+
+flags=(-I include -m64 -std=c++26 -Wall -O3 ${CXXFLAGS})
+
+sizes=(8 32 128 256)
+types=(int double char std::string float long short)
+apis=(baseline fuple fuple_cat tuple_cat fuple_cat_16x16 tuple_cat_16x16 zip compare index io member_names member_stem)
+
+version=$(sed -n 's/^#define FMP_VERSION_NUMBER \(.*\)/\1/p' include/version.hpp)
+revision=$(git rev-parse --short HEAD 2>/dev/null)
+
+generate()
+{
+    local n=$1
+    local header=${dst}/fields_${n}.hpp
+
+    {
+        echo "#include <string>"
+        echo
+
+        echo "struct S"
+        echo "{"
+
+        for ((i = 0; i < n; ++i)); do
+              echo "    ${types[i % ${#types[@]}]} m${i};"
+        done
+
+        echo "};"
+        echo
+
+        echo -n "#define FMP_BENCH_TYPES "
+        for ((i = 0; i < n; ++i)); do
+              echo -n "${types[i % ${#types[@]}]}$( ((i + 1 < n)) && echo -n ', ')"
+        done
+        echo
+
+        echo -n "#define FMP_BENCH_MPTRS "
+        for ((i = 0; i < n; ++i)); do
+              echo -n "&S::m${i}$( ((i + 1 < n)) && echo -n ', ')"
+        done
+        echo
+    } > ${header}
+
+    echo ${header}
+}
+
+measure()
+{
+    local api=$1
+    local header=$2
+
+    local macro=FMP_BENCH_${api^^}
+    local cmd=(${cxx} "${flags[@]}" -include ${header} -D${macro} -c -o /dev/null ${path}/compile_time.cpp)
+
+    if [[ -x /usr/bin/time ]]; then
+        /usr/bin/time -f "%e %M" -o ${dst}/compile_time.log "${cmd[@]}" || return 1
+        cat ${dst}/compile_time.log
+    else
+        local start=$(date +%s%N)
+
+        "${cmd[@]}" || return 1
+        echo "$(( ($(date +%s%N) - start) / 1000000 ))e-3 null"
+    fi
+}
+
+printf "%-16s %8s %12s %12s\n" api fields seconds kbytes
+
+{
+    echo "{"
+    echo "  \"version\": \"fmp/${version}\","
+    echo "  \"revision\": \"${revision}\","
+    echo "  \"compiler\": \"$(${cxx} --version | head -1)\","
+    echo "  \"results\": ["
+} > ${json}
+
+sep=""
+
+for n in ${sizes[@]}; do
+      header=$(generate ${n})
+
+      for api in ${apis[@]}; do
+            read seconds kbytes < <(measure ${api} ${header} || echo "null null")
+            printf "%-16s %8s %12s %12s\n" ${api} ${n} ${seconds} ${kbytes}
+
+            echo -n "${sep}    { \"api\": \"${api}\", \"fields\": ${n}, \"seconds\": ${seconds}, \"kbytes\": ${kbytes} }" >> ${json}
+            sep=$',\n'
+      done
+done
+
+{
+    echo
+    echo "  ]"
+    echo "}"
+} >> ${json}
+
+echo Please check the results at ${json}
@@ -4,7 +4,7 @@ dst=/tmp
 path=example
 
 flags=(-I include -m64 -std=c++26 -s -Wall -O3)
-executables=(fuple lists reflect fmp member_info visitor invocable_name)
+executables=(fuple lists reflect fmp member_info visitor invocable_name profiler policy crc32c compress diff tracked decoder rpc registry layout)
 
 for bin in ${executables[@]}; do
       g++ "${flags[@]}" -o ${dst}/${bin} ${path}/${bin}.cpp
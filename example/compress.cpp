@@ -0,0 +1,103 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+// g++ -I include -m64 -std=c++26 -s -Wall -O3 -o /tmp/compress example/compress.cpp
+
+#include <vector>
+#include <cassert>
+#include <iostream>
+#include <compress.hpp>
+
+// compress batches of marshaled messages chunk by chunk
+
+struct W
+{
+    int rank;
+    std::string key;
+    std::string val;
+    std::vector<int> tags;
+};
+
+int main(int argc, char* argv[])
+{
+    // a block codec for any bytes
+
+    std::string s;
+
+    for (int i = 0; i != 1000; ++i)
+         s += "key" + std::to_string(i % 10) + "value";
+
+    std::string c(fmp::compress_bound(s.size()), 0);
+    c.resize(fmp::compress(s.data(), s.size(), c.data()));
+
+    assert(c.size() < s.size() / 4);
+
+    std::string d(s.size(), 0);
+
+    assert(fmp::decompress(c.data(), c.size(), d.data(), d.size()) == s.size());
+    assert(d == s);
+
+    // a malformed block is detected instead of overrunning the output
+
+    assert(fmp::decompress(c.data(), c.size(), d.data(), d.size() - 1) == fmp::npos);
+    assert(fmp::decompress(c.data(), c.size() - 1, d.data(), d.size()) != s.size());
+
+    // write a batch of messages in chunks of 4096 bytes
+
+    fmp::batch_writer bw(4096);
+    size_t raw = 0;
+
+    for (int i = 0; i != 10000; ++i)
+    {
+         W w { i, "routing/key/" + std::to_string(i % 500), "next-hop-" + std::to_string(i % 7), { 1, 2, i % 3 } };
+
+         raw += fmp::size_bytes(w);
+         bw.write(w);
+    }
+
+    const std::string& batch = bw.str();
+    std::cout << raw << " bytes compressed to " << batch.size() << std::endl;
+
+    assert(batch.size() < raw / 2);
+
+    // read the messages back, a chunk is decompressed at a time
+
+    fmp::batch_reader br(batch);
+
+    W w;
+    int n = 0;
+
+    while (br.read(w))
+    {
+         assert(w.rank == n);
+         assert(w.key == "routing/key/" + std::to_string(n % 500));
+
+         ++n;
+    }
+
+    assert(n == 10000);
+    assert(!br.corrupted);
+
+    // policies apply to every message of a batch
+
+    fmp::batch_writer fw;
+
+    fw.write(W { 1, "framed", "message", {} }, fmp::framed());
+    fw.write(W { 2, "framed", "message", {} }, fmp::framed());
+
+    fmp::framed fr;
+    fmp::batch_reader frr(fw.str());
+
+    while (frr.read(w, fr))
+         assert(!fr.corrupted);
+
+    assert(w.rank == 2);
+
+    return 0;
+}
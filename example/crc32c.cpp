@@ -0,0 +1,41 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+// g++ -I include -m64 -std=c++26 -s -Wall -O3 -msse4.2 -o /tmp/crc32c example/crc32c.cpp
+
+#include <string>
+#include <cassert>
+#include <iostream>
+#include <crc32c.hpp>
+
+// crc32c with the crc32 instructions of sse4.2 or armv8, or a slicing by 8 table otherwise
+
+int main(int argc, char* argv[])
+{
+    std::string s = "123456789";
+
+    // the check value of crc32c
+
+    assert(fmp::crc32c(s.data(), s.size()) == 0xe3069283);
+    assert(fmp::crc32c(s.data(), 0) == 0);
+
+    // continue a checksum over the next bytes
+
+    std::string b(1000, 0);
+
+    for (size_t i = 0; i != b.size(); ++i)
+         b[i] = char(i * 7);
+
+    uint32_t crc = fmp::crc32c(b.data(), 13);
+    assert(fmp::crc32c(b.data() + 13, b.size() - 13, crc) == fmp::crc32c(b.data(), b.size()));
+
+    std::cout << std::hex << fmp::crc32c(b.data(), b.size()) << std::endl;
+
+    return 0;
+}
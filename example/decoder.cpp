@@ -0,0 +1,215 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+// g++ -I include -m64 -std=c++26 -s -Wall -O3 -o /tmp/decoder example/decoder.cpp
+
+#include <map>
+#include <set>
+#include <list>
+#include <array>
+#include <deque>
+#include <vector>
+#include <variant>
+#include <cassert>
+#include <iostream>
+#include <optional>
+#include <forward_list>
+#include <unordered_map>
+#include <decoder.hpp>
+
+// decode messages as their bytes arrive from a non-blocking socket
+
+struct X
+{
+    float f;
+    std::string s;
+};
+
+struct Z
+{
+    int i;
+    double d;
+    char c;
+    X x;
+    X* ptr;
+    std::string s;
+    std::list<int> ages;
+    std::deque<std::string> names;
+    std::vector<X> xs;
+    std::vector<double> values;
+    std::forward_list<std::vector<int>> ints;
+    std::shared_ptr<X> sp;
+    std::array<X, 3> arrs;
+    std::optional<X> opt;
+    std::set<int> sets;
+    std::map<int, std::string> maps;
+    std::unordered_map<int, std::string> unordered_maps;
+    std::tuple<int, std::string> tup;
+};
+
+int main(int argc, char* argv[])
+{
+    X x { 53.86f, "reflect" };
+
+    Z z { 18, 9.87, '*', x, &x, "TMP", { 1, 3, 6 }, { "fmp", "C++", "template" }, { x, x, x }, { 0.5, 1.5, 2.5 },
+          { { 0, 1, 2 }, { 4, 5 } }, std::make_shared<X>(15.18f, "shared"), { x, x, x }, x, { 3, 2, 5 },
+          { { 2, "two" }, { 1, "one" } }, { { 5, "five" } }, { 7, "seven" } };
+
+    std::string s = fmp::marshal(z);
+
+    auto check = [&](const Z& r)
+    {
+        assert(fmp::eq(r.x, z.x));
+        assert(fmp::eq(*r.ptr, x));
+        assert(fmp::eq(*r.sp, *z.sp));
+
+        assert(r.i == z.i && r.d == z.d && r.c == z.c && r.s == z.s);
+        assert(r.ages == z.ages && r.names == z.names && r.values == z.values && r.ints == z.ints);
+
+        assert(r.xs.size() == 3 && fmp::eq(r.xs[2], x));
+        assert(r.arrs.size() == 3 && fmp::eq(r.arrs[1], x));
+
+        assert(r.opt && fmp::eq(*r.opt, x));
+        assert(r.sets == z.sets && r.maps == z.maps && r.unordered_maps == z.unordered_maps);
+        assert(r.tup == z.tup);
+
+        delete r.ptr;
+    };
+
+    // the bytes arrive one at a time, no byte is decoded twice
+
+    {
+        Z r {};
+        fmp::decoder d(r);
+
+        for (size_t i = 0; i != s.size(); ++i)
+        {
+             assert(!d.done());
+             auto p = d.feed(&s[i], 1);
+
+             assert(p == (i + 1 == s.size() ? fmp::progress::done : fmp::progress::more));
+             assert(d.pending() < sizeof(uint64_t));
+        }
+
+        check(r);
+    }
+
+    // chunks of any size
+
+    for (size_t n : { 2, 3, 5, 7, 16, 100 })
+    {
+         Z r {};
+         fmp::decoder d(r);
+
+         for (size_t i = 0; i < s.size(); i += n)
+              d.feed(s.data() + i, std::min(n, s.size() - i));
+
+         assert(d.done());
+         check(r);
+    }
+
+    // two messages in a stream, the bytes past the first are kept for the next
+
+    {
+        X a { 1.5f, "first" };
+        X b { 2.5f, "second" };
+
+        std::string m = fmp::marshal(a);
+        fmp::marshal(m, b);
+
+        X r {};
+        fmp::decoder d(r);
+
+        assert(d.feed(m.data(), 10) == fmp::progress::more);
+        assert(d.feed(m.data() + 10, m.size() - 10) == fmp::progress::done);
+
+        assert(fmp::eq(r, a));
+        assert(d.pending() == m.size() - fmp::size_bytes(a));
+
+        assert(d.start(r) == fmp::progress::done);
+        assert(fmp::eq(r, b));
+        assert(d.pending() == 0);
+    }
+
+    // the existing objects and nodes are decoded into under reuse
+
+    {
+        Z r {};
+        fmp::unmarshal(s, r, fmp::reuse());
+
+        auto ptr = r.ptr;
+        r.maps[9] = "nine";
+
+        fmp::decoder d(r, fmp::reuse());
+
+        for (size_t i = 0; i < s.size(); i += 4)
+             d.feed(s.data() + i, std::min<size_t>(4, s.size() - i));
+
+        assert(d.done());
+        assert(r.ptr == ptr);
+
+        check(r);
+    }
+
+    // a std::array takes no more elements than it holds, the others are decoded and dropped
+
+    {
+        auto v = std::make_tuple(std::vector<int> { 1, 2, 3, 4, 5 }, std::vector<std::string> { "a", "b", "c" }, 6);
+        std::string b = fmp::marshal(v);
+
+        std::tuple<std::array<int, 3>, std::array<std::string, 2>, int> r {};
+
+        for (size_t n : { size_t(1), b.size() })
+        {
+             fmp::decoder d(r);
+
+             for (size_t i = 0; i < b.size(); i += n)
+                  d.feed(b.data() + i, std::min(n, b.size() - i));
+
+             assert(d.done() && d.pending() == 0);
+
+             assert((std::get<0>(r) == std::array<int, 3> { 1, 2, 3 }));
+             assert((std::get<1>(r) == std::array<std::string, 2> { "a", "b" } && std::get<2>(r) == 6));
+        }
+    }
+
+    // a variant index out of range resets the variant, decoding goes on with the next member
+
+    {
+        int i = 7;
+        std::string b = std::string(sizeof(uint32_t), '\xff') + fmp::marshal(i);
+
+        std::tuple<std::variant<int, std::string>, int> r { "stale", 0 };
+        fmp::decoder d(r);
+
+        d.feed(b.data(), b.size());
+
+        assert(d.done() && d.pending() == 0);
+        assert(std::get<0>(r).index() == 0 && std::get<1>(r) == 7);
+    }
+
+    // a policy gives the byte order
+
+    {
+        std::string b = fmp::marshal(z, fmp::big_endian());
+
+        Z r {};
+        fmp::decoder d(r, fmp::big_endian());
+
+        for (size_t i = 0; i < b.size(); i += 3)
+             d.feed(b.data() + i, std::min<size_t>(3, b.size() - i));
+
+        assert(d.done());
+        check(r);
+    }
+
+    std::cout << "decoded " << s.size() << " bytes" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+// g++ -I include -m64 -std=c++26 -s -Wall -O3 -o /tmp/diff example/diff.cpp
+
+#include <map>
+#include <vector>
+#include <cassert>
+#include <iostream>
+#include <optional>
+#include <diff.hpp>
+
+// replicate the changes of an object instead of the whole object
+
+struct X
+{
+    float f;
+    std::string s;
+};
+
+struct Y
+{
+    int i;
+    double d;
+    X x;
+    X* ptr;
+    std::string s;
+    std::vector<X> xs;
+    std::optional<int> opt;
+    std::map<int, std::string> maps;
+    std::tuple<int, X> tup;
+};
+
+int main(int argc, char* argv[])
+{
+    X x { 1.5f, "pointee" };
+    X z { 1.5f, "pointee" };
+
+    Y a { 1, 2.5, { 3.5f, "nested" }, &x, "a string", { x, x }, std::nullopt, { { 1, "one" } }, { 7, x } };
+    Y b = a;
+
+    // nothing changed, a patch is the bitmask only
+
+    auto p0 = fmp::diff(a, b);
+
+    assert(p0.size() == 2);
+    assert(p0 == std::string(2, '\0'));
+
+    // pointees are compared rather than the addresses
+
+    b.ptr = &z;
+    assert(fmp::diff(a, b).size() == 2);
+
+    // one integer changed
+
+    b.i = 2;
+    auto p1 = fmp::diff(a, b);
+
+    assert(p1.size() == 2 + sizeof(int));
+
+    // a nested member changed, only its own bitmask and value are encoded
+
+    b.x.f = 4.5f;
+    std::get<1>(b.tup).s = "changed";
+
+    auto p2 = fmp::diff(a, b);
+    assert(p2.size() < fmp::size_bytes(b) / 2);
+
+    Y c = a;
+    fmp::apply_patch(c, p2);
+
+    assert(c.i == b.i);
+    assert(c.x.f == b.x.f);
+
+    assert(c.x.s == a.x.s);
+    assert(std::get<1>(c.tup).s == "changed");
+
+    assert(fmp::same(c, b));
+    assert(fmp::diff(c, b) == p0);
+
+    // containers and optionals are replaced as a whole
+
+    b.xs.push_back({ 9.5f, "appended" });
+    b.opt = 42;
+    b.maps.emplace(2, "two");
+
+    Y e = a;
+    fmp::apply_patch(e, fmp::diff(a, b));
+
+    assert(e.xs.size() == 3);
+    assert(*e.opt == 42);
+
+    assert(e.maps == b.maps);
+    assert(fmp::same(e, b));
+
+    // policies carry over to the values of a patch
+
+    auto p3 = fmp::diff(a, b, fmp::big_endian());
+
+    Y f = a;
+    fmp::apply_patch(f, p3, fmp::big_endian());
+
+    assert(fmp::same(f, b));
+
+    // patches of many objects can be appended to one buffer
+
+    std::string s;
+
+    fmp::diff(s, a, b);
+    fmp::diff(s, b, a);
+
+    size_t l = 0;
+    Y g = a;
+
+    fmp::apply_patch(l, s, g, fmp::policy());
+    assert(fmp::same(g, b));
+
+    fmp::apply_patch(l, s, g, fmp::policy());
+    assert(fmp::same(g, a));
+
+    assert(l == s.size());
+
+    std::cout << "patch " << fmp::diff(a, b).size() << " bytes, object " << fmp::size_bytes(b) << " bytes" << std::endl;
+
+    return 0;
+}
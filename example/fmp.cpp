@@ -63,6 +63,8 @@ int main(int argc, char* argv[])
     assert(fmp::index(&X::s) == 1);
     assert(fmp::index(&Y::x) == 3);
 
+    static_assert(fmp::index_v<&W::val> == 2);
+
     static_assert(fmp::tuple_size_v<X> == 2);
     static_assert(fmp::tuple_size_v<Y> == 4);
 
@@ -168,5 +168,61 @@ int main(int argc, char* argv[])
     assert(fmp::get<0>(tf) == 100);
     assert(std::get<1>(ft) == 'S');
 
+    // a fuple of trivially copyable elements is trivially copyable, a fuple of references assigns
+    // through them
+
+    static_assert(std::is_trivially_copyable_v<fmp::fuple<int, double>>);
+    static_assert(std::is_trivially_copy_assignable_v<fmp::fuple<int, double>>);
+
+    int r1 = 1;
+    int r2 = 2;
+
+    fmp::fuple<int&> rf1(r1);
+    fmp::fuple<int&> rf2(r2);
+
+    rf1 = rf2;
+    assert(r1 == 2);
+
+    // an empty element takes no storage
+
+    struct stateless
+    {
+        int operator()(int i) const
+        {
+            return i + 1;
+        }
+    };
+
+    static_assert(sizeof(fmp::fuple<stateless, int>) == sizeof(int));
+    static_assert(sizeof(fmp::fuple<int, std::less<int>, fmp::ignore_t>) == sizeof(int));
+
+    fmp::fuple<stateless, int> sf({}, 7);
+
+    assert(fmp::get<0>(sf)(fmp::get<1>(sf)) == 8);
+
+    // a packed_fuple stores its elements by decreasing alignment, without the padding between them,
+    // and still presents them in the order they are declared
+
+    using packed = fmp::packed_fuple<char, double, char, double>;
+
+    static_assert(sizeof(fmp::fuple<char, double, char, double>) == 32);
+    static_assert(sizeof(packed) == 24);
+
+    static_assert(std::is_same_v<fmp::fuple_element_t<2, packed>, char>);
+
+    packed pf('a', 1.5, 'b', 2.5);
+    fmp::fuple<char, double, char, double> uf = pf;
+
+    assert(fmp::get<2>(pf) == 'b');
+    assert(uf == pf);
+
+    std::tuple<char, double, char, double> ut = pf;
+    packed pt = ut;
+
+    fmp::get<3>(pt) = 3.5;
+
+    assert(pf < pt);
+    assert(std::get<1>(ut) == 1.5);
+
     return 0;
 }
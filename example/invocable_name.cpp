@@ -149,6 +149,15 @@ int main(int argc, char* argv[])
     std::cout << fmp::invocable_stem_v<[]<float i, typename T>(char a, T t){}> << std::endl;
     std::cout << fmp::invocable_stem_v<[k]<auto... N, typename T>(int a, T t){}> << std::endl;
 
+    std::cout << std::endl << "type_name" << std::endl;
+    std::cout << fmp::type_name<Week>() << std::endl;
+    std::cout << fmp::type_name<K::U::V>() << std::endl;
+    std::cout << fmp::type_name<std::tuple<int, X>>() << std::endl;
+    std::cout << fmp::type_name_v<decltype(nest1::f)> << std::endl;
+
+    static_assert(fmp::type_name_v<int> == "int");
+    static_assert(fmp::type_name_v<K::Z> == "K::Z");
+
     std::cout << std::endl << "pretty function" << std::endl;
     std::cout << loc::pretty_function<main>() << std::endl;
     std::cout << loc::pretty_function<push>() << std::endl;
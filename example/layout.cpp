@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+// g++ -I include -m64 -std=c++26 -s -Wall -O3 -o /tmp/layout example/layout.cpp
+
+#include <sstream>
+#include <cassert>
+#include <iostream>
+#include <layout.hpp>
+
+// the members in the order they were added, padded after every narrow one
+
+struct Order
+{
+    bool buy;
+    double price;
+    char side;
+    int64_t quantity;
+    int16_t venue;
+    std::string account;
+};
+
+// the same members by decreasing alignment
+
+struct Packed
+{
+    double price;
+    int64_t quantity;
+    std::string account;
+    int16_t venue;
+    bool buy;
+    char side;
+};
+
+struct Empty
+{
+};
+
+// an over-aligned member is placed where its type alone doesn't tell
+
+struct Aligned
+{
+    int a;
+    alignas(64) int b;
+};
+
+int main(int argc, char* argv[])
+{
+    constexpr auto& o = fmp::layout_v<Order>;
+
+    static_assert(o.count == 6 && o.size == sizeof(Order) && o.align == alignof(Order));
+
+    static_assert(o.members[1].name == "price" && o.members[1].offset == 8 && o.members[1].size == 8);
+    static_assert(o.members[0].padding == 7 && o.members[2].padding == 7 && o.members[4].padding == 6);
+
+    static_assert(o.members[3].trivial && !o.members[5].trivial);
+    static_assert(o.padding == 20 && o.packed == sizeof(Packed) && o.waste() == 16);
+
+    // the reordering by decreasing alignment, members of the same alignment keep their order
+
+    static_assert(o.order == std::array<size_t, 6>{ 1, 3, 5, 4, 0, 2 });
+
+    // a hot struct can be kept from regressing past a number of padding bytes
+
+    static_assert(fmp::layout_v<Packed>.padding <= 4 && !fmp::layout_v<Packed>.waste());
+
+    // a record without members takes a byte, which no reordering saves
+
+    static_assert(fmp::layout_v<Empty>.count == 0 && fmp::layout_v<Empty>.padding == 1 && !fmp::layout_v<Empty>.waste());
+
+    // nor a record whose members don't add up to it
+
+    static_assert(!fmp::layout_v<Aligned>.exact && !fmp::layout_v<Aligned>.waste() && fmp::layout_v<Order>.exact);
+
+    std::ostringstream os;
+    fmp::layout_v<Packed>.report(os);
+
+    assert(os.str().find("reordered") == std::string::npos);
+
+    fmp::layout_v<Aligned>.report(os);
+    assert(os.str().find("reordered") == std::string::npos && os.str().find("inexact") != std::string::npos);
+
+    o.report(std::cout);
+
+    return 0;
+}
@@ -12,7 +12,8 @@
 #include <cassert>
 #include <lists.hpp>
 
-// An expression template (fused operations) to generate type list and index sequence for fmp::fuple_cat and fmp::tuple_cat
+// Type and value packs joined by operator+, and the index table of a concatenation, filled in a single pass,
+// that fmp::fuple_cat and fmp::tuple_cat expand
 
 int main(int argc, char* argv[])
 {
@@ -26,5 +27,11 @@ int main(int argc, char* argv[])
 
     assert(c1 == c2);
 
+    using C = fmp::concat<2, 0, 1, 3>;
+
+    static_assert(C::size == 6);
+    static_assert(C::indices[2] == std::array<size_t, 2>{ 2, 0 });
+    static_assert(C::indices[5] == std::array<size_t, 2>{ 3, 2 });
+
     return 0;
 }
@@ -0,0 +1,370 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+// g++ -I include -m64 -std=c++26 -s -Wall -O3 -o /tmp/policy example/policy.cpp
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <variant>
+#include <optional>
+#include <cassert>
+#include <iostream>
+#include <fmp.hpp>
+
+// policies customize how a structure is marshaled and unmarshaled
+
+struct X
+{
+    float f;
+    std::pmr::string s;
+};
+
+struct Y
+{
+    int i;
+    X* ptr;
+    std::pmr::string s;
+    std::shared_ptr<X> sp;
+    std::pmr::vector<X> xs;
+    std::pmr::vector<std::pmr::string> names;
+    std::pmr::map<std::pmr::string, std::pmr::string> maps;
+};
+
+// two revisions of a structure, members were reordered, removed and added
+
+struct V1
+{
+    int id;
+    std::string name;
+    std::vector<int> scores;
+    double ratio;
+
+    bool operator==(const V1&) const = default;
+};
+
+struct V2
+{
+    std::string name;
+    int id;
+    std::optional<std::string> email;
+    std::vector<int> scores;
+};
+
+// pin explicit ids to the members rather than hashing their names
+
+struct V3
+{
+    int identity;
+    std::string label;
+};
+
+struct V4
+{
+    std::pair<int, std::string> p;
+    std::vector<std::pair<int, double>> ps;
+};
+
+template <>
+inline constexpr auto fmp::member_tags_v<V3> = std::array<uint32_t, 2>{ fmp::member_tags_v<V1>[0], fmp::member_tags_v<V1>[1] };
+
+int main(int argc, char* argv[])
+{
+    X x { 15.32f, "a string that is too long for the small buffer" };
+    Y y { 2048, &x, "a polymorphic string of the memory resource", std::make_shared<X>(x), { x, x },
+          { "fmp", "a name that is too long for the small buffer" }, { { "template", "a value that is too long for the small buffer" } } };
+
+    std::string s = fmp::marshal(y);
+
+    // unmarshal into an arena, every allocation of the message is served by the resource
+
+    char buffer[4096];
+    std::pmr::monotonic_buffer_resource mr(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+    {
+        fmp::arena a;
+        a.resource = &mr;
+
+        auto z = fmp::unmarshal<Y>(s, a);
+
+        assert(z.s.get_allocator().resource() == &mr);
+        assert(z.xs.get_allocator().resource() == &mr);
+
+        assert(z.ptr->s.get_allocator().resource() == &mr);
+        assert(z.sp->s.get_allocator().resource() == &mr);
+
+        assert(z.xs[1].s.get_allocator().resource() == &mr);
+        assert(z.names[1].get_allocator().resource() == &mr);
+
+        assert(z.maps.begin()->second.get_allocator().resource() == &mr);
+
+        assert(z.ptr->s == x.s);
+        assert(z.sp->s == x.s);
+
+        assert(z.xs[0].s == x.s);
+        assert(z.names == y.names);
+
+        assert(z.maps == y.maps);
+        assert(fmp::marshal(z) == s);
+    }
+
+    // release the whole message graph at once
+
+    mr.release();
+
+    // unmarshal into an existing object, reusing its nodes, capacities and pointees
+
+    Y r {};
+    fmp::unmarshal(s, r, fmp::reuse());
+
+    auto ptr = r.ptr;
+    auto sp = r.sp.get();
+
+    auto data = r.xs.data();
+    auto node = &*r.maps.begin();
+
+    auto key = r.maps.begin()->first.data();
+    auto val = r.maps.begin()->second.data();
+
+    for (int i = 0; i != 3; ++i)
+    {
+         fmp::unmarshal(s, r, fmp::reuse());
+
+         assert(r.ptr == ptr);
+         assert(r.sp.get() == sp);
+
+         assert(r.xs.data() == data);
+         assert(&*r.maps.begin() == node);
+
+         assert(r.maps.begin()->first.data() == key);
+         assert(r.maps.begin()->second.data() == val);
+
+         assert(fmp::marshal(r) == s);
+    }
+
+    // associative containers are cleared rather than merged
+
+    r.maps.emplace("stale", "entry");
+    fmp::unmarshal(s, r, fmp::reuse());
+
+    assert(r.maps == y.maps);
+
+    // an object unmarshaled by value starts value initialized, so its pointers are null
+
+    auto v = fmp::unmarshal<Y>(s, fmp::reuse());
+    assert(v.ptr->s == x.s && fmp::marshal(v) == s);
+
+    delete v.ptr;
+
+    // combine the policies
+
+    fmp::policies<fmp::arena, fmp::reuse> ar;
+    ar.resource = &mr;
+
+    fmp::unmarshal(s, r, ar);
+
+    assert(r.ptr == ptr);
+    assert(r.xs.get_allocator().resource() == &mr);
+
+    delete ptr;
+
+    // the tagged format is forward and backward compatible
+
+    V1 v1 { 7, "fmp", { 1, 2, 3 }, 0.75 };
+    std::string t1 = fmp::marshal(v1, fmp::tagged());
+
+    assert(t1.size() == fmp::size_bytes(v1, fmp::tagged()));
+
+    auto v2 = fmp::unmarshal<V2>(t1, fmp::tagged());
+
+    assert(v2.id == v1.id);
+    assert(v2.name == v1.name);
+
+    assert(!v2.email);
+    assert(v2.scores == v1.scores);
+
+    v2.email = "fmp@example.com";
+    std::string t2 = fmp::marshal(v2, fmp::tagged());
+
+    auto v3 = fmp::unmarshal<V1>(t2, fmp::tagged());
+
+    assert(v3.id == v1.id);
+    assert(v3.scores == v1.scores);
+
+    auto v4 = fmp::unmarshal<V3>(t1, fmp::tagged());
+
+    assert(v4.identity == v1.id);
+    assert(v4.label == v1.name);
+
+    // pairs are tagged by their indices
+
+    V4 v7 { { 1, "one" }, { { 2, 2.5 }, { 3, 3.5 } } };
+    auto v8 = fmp::unmarshal<V4>(fmp::marshal(v7, fmp::tagged()), fmp::tagged());
+
+    assert(v8.p == v7.p && v8.ps == v7.ps);
+
+    // a message is appended to what the output holds already
+
+    std::string t3 = "head";
+    fmp::marshal(t3, v4, fmp::tagged());
+
+    assert(t3.substr(0, 4) == "head");
+    assert(fmp::unmarshal<V1>(t3.substr(4), fmp::tagged()).name == v1.name);
+
+    // the schemas match, the decoder takes a straight line
+
+    assert(fmp::marshal(fmp::unmarshal<V1>(t1, fmp::tagged()), fmp::tagged()) == t1);
+
+    // the fingerprint of a schema changes with the member names, types and nesting
+
+    static_assert(fmp::schema_hash_v<V1> != fmp::schema_hash_v<V2>);
+    static_assert(fmp::schema_hash_v<V1> != fmp::schema_hash_v<V3>);
+
+    static_assert(fmp::schema_hash_v<X> == fmp::schema_hash_v<const X&>);
+    static_assert(fmp::schema_hash_v<X> != fmp::schema_hash_v<Y>);
+
+    // embed the fingerprint in the message, a mismatched message is rejected instead of decoded
+
+    fmp::fingerprint fp;
+    std::string f1 = fmp::marshal(v1, fp);
+
+    assert(f1.size() == sizeof(uint64_t) + fmp::size_bytes(v1));
+
+    std::string f2 = "head";
+    fmp::marshal(f2, v1, fp);
+
+    assert(f2 == "head" + f1);
+
+    auto v5 = fmp::unmarshal<V1>(f1, fp);
+
+    assert(!fp.rejected);
+    assert(v5.name == v1.name);
+
+    V2 v6 {};
+    fmp::unmarshal(f1, v6, fp);
+
+    assert(fp.rejected);
+    assert(v6.name.empty());
+
+    // fingerprinted and tagged
+
+    fmp::policies<fmp::fingerprint, fmp::tagged> ft;
+    fmp::unmarshal(fmp::marshal(v1, ft), v6, ft);
+
+    assert(ft.rejected);
+
+    // a portable byte order, the fundamentals and the size prefixes are swapped unless the order is native
+
+    auto e1 = std::make_tuple(uint32_t(0x01020304), std::vector<double> { 1.5, -2.25 }, std::u16string(u"fmp"), v1);
+
+    std::string be = fmp::marshal(e1, fmp::big_endian());
+    std::string le = fmp::marshal(e1, fmp::little_endian());
+
+    assert(be.substr(0, 4) == std::string("\x01\x02\x03\x04", 4));
+    assert(le.substr(0, 4) == std::string("\x04\x03\x02\x01", 4));
+
+    assert(fmp::marshal(e1, fmp::native_endian()) == fmp::marshal(e1));
+    assert(fmp::marshal(e1) == (std::endian::native == std::endian::big ? be : le));
+
+    assert(fmp::unmarshal<decltype(e1)>(be, fmp::big_endian()) == e1);
+    assert(fmp::unmarshal<decltype(e1)>(le, fmp::little_endian()) == e1);
+
+    // tagged and big endian
+
+    fmp::policies<fmp::tagged, fmp::big_endian> tb;
+    assert(fmp::unmarshal<decltype(e1)>(fmp::marshal(e1, tb), tb) == e1);
+
+    // checksummed frames of [length][crc32c][payload], a batch is a run of frames
+
+    fmp::framed fr;
+    std::string batch;
+
+    for (int i = 0; i != 3; ++i)
+    {
+         v1.id = i;
+         batch += fmp::marshal(v1, fr);
+    }
+
+    size_t frame = fmp::size_bytes(v1, fr);
+
+    assert(batch.size() == 3 * frame);
+    assert(frame == sizeof(uint64_t) + sizeof(uint32_t) + fmp::size_bytes(v1));
+
+    batch[frame + 20] ^= 0x40;
+
+    size_t l = 0;
+    std::vector<int> ids;
+
+    while (l != batch.size())
+    {
+         V1 v {};
+         fmp::unmarshal(l, batch, v, fr);
+
+         if (!fr.corrupted)
+             ids.push_back(v.id);
+    }
+
+    assert((ids == std::vector<int> { 0, 2 }));
+
+    // a truncated frame is detected too
+
+    fmp::unmarshal(batch.substr(0, frame - 1), v1, fr);
+    assert(fr.corrupted);
+
+    fmp::unmarshal(batch.substr(0, 5), v1, fr);
+    assert(fr.corrupted);
+
+    // a valueless variant is written with an index out of range, reading it is corrupted and resets the
+    // variant
+
+    struct Fail
+    {
+        operator std::deque<int>() const
+        {
+            throw 0;
+        }
+    };
+
+    std::variant<int, std::deque<int>> w0 = 1, w1 = std::deque<int> { 2 };
+
+    try
+    {
+        w0.emplace<1>(Fail());
+    }
+    catch (int)
+    {
+    }
+
+    assert(w0.valueless_by_exception());
+
+    fmp::unmarshal(fmp::marshal(w0, fr), w1, fr);
+    assert(fr.corrupted && w1.index() == 0);
+
+    // a frame is appended to what the output holds already
+
+    std::string f3 = batch.substr(0, frame);
+    fmp::marshal(f3, v1, fr);
+
+    assert(f3.size() == 2 * frame && f3.substr(0, frame) == batch.substr(0, frame));
+
+    // framed, fingerprinted, tagged and big endian
+
+    fmp::policies<fmp::framed, fmp::fingerprint, fmp::tagged, fmp::big_endian> all;
+    std::string f4 = fmp::marshal(e1, all);
+
+    assert(fmp::unmarshal<decltype(e1)>(f4, all) == e1);
+    assert(!all.corrupted && !all.rejected);
+
+    f4.back() ^= 1;
+    fmp::unmarshal<decltype(e1)>(f4, all);
+
+    assert(all.corrupted);
+
+    return 0;
+}
@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+// g++ -I include -m64 -std=c++26 -s -Wall -O3 -o /tmp/profiler example/profiler.cpp
+
+#include <map>
+#include <vector>
+#include <cassert>
+#include <iostream>
+#include <profiler.hpp>
+
+// account the serialized bytes, the decode allocations and the time spent per member path
+
+struct X
+{
+    float f;
+    std::string s;
+};
+
+struct Y
+{
+    int i;
+    X x;
+    X* ptr;
+    std::vector<X> xs;
+    std::map<int, std::string> maps;
+};
+
+struct Z
+{
+    std::pair<int, X> p;
+    std::vector<std::pair<int, std::string>> ps;
+};
+
+int main(int argc, char* argv[])
+{
+    X x { 15.32f, "template" };
+    Y y { 2048, { 27.85f, "fmp" }, &x, { x, x }, { { 1, "one" }, { 2, "two" } } };
+
+    // marshal with an instrumented policy
+
+    fmp::profiler mp;
+    std::string s = fmp::marshal(y, mp);
+
+    assert(s == fmp::marshal(y));
+
+    // the bytes written per member path, nested members are accounted to their parents
+
+    auto row = [](const fmp::profiler& p, std::string_view path)
+    {
+        for (auto& r : p)
+             if (r.path == path)
+                 return r;
+
+        return fmp::profiler::record();
+    };
+
+    assert(row(mp, "i").bytes == sizeof(int));
+    assert(row(mp, "x").bytes == fmp::size_bytes(y.x));
+
+    assert(row(mp, "x.s").bytes == sizeof(size_t) + y.x.s.size());
+    assert(row(mp, "xs.s").calls == y.xs.size());
+
+    assert(row(mp, "i").bytes + row(mp, "x").bytes + row(mp, "ptr").bytes + row(mp, "xs").bytes + row(mp, "maps").bytes == s.size());
+
+    // unmarshal with an instrumented policy
+
+    fmp::profiler up;
+    auto z = fmp::unmarshal<Y>(s, up);
+
+    assert(z.x.s == "fmp");
+    assert(z.ptr->s == "template");
+
+    assert(row(up, "ptr").allocations >= 1);
+    assert(row(up, "maps").allocations >= y.maps.size());
+
+    assert(row(up, "xs").bytes == row(mp, "xs").bytes);
+
+    // visit the table
+
+    size_t bytes = 0;
+
+    up.visit([&](auto& path, auto calls, auto b, auto allocations, auto elapsed)
+    {
+        if (path.find('.') == std::string::npos)
+            bytes += b;
+    });
+
+    assert(bytes == s.size());
+
+    up.report(std::cout);
+
+    delete z.ptr;
+
+    // the members of a pair are labeled by their indices
+
+    Z w { { 1, x }, { { 2, "two" }, { 3, "three" } } };
+
+    fmp::profiler pp;
+    std::string t = fmp::marshal(w, pp);
+
+    assert(t == fmp::marshal(w));
+
+    assert(row(pp, "p.1.s").bytes == sizeof(size_t) + x.s.size());
+    assert(row(pp, "ps.1").calls == w.ps.size());
+
+    return 0;
+}
@@ -9,6 +9,7 @@
 
 // g++ -I include -m64 -std=c++26 -s -Wall -O3 -o /tmp/reflect example/reflect.cpp
 
+#include <any>
 #include <map>
 #include <set>
 #include <list>
@@ -16,15 +17,23 @@
 #include <deque>
 #include <vector>
 #include <cassert>
+#include <cstring>
+#include <variant>
 #include <iostream>
 #include <forward_list>
 #include <unordered_map>
 #include <unordered_set>
 #include <reflect.hpp>
 
+#if __has_include(<flat_map>)
+#include <flat_map>
+#include <flat_set>
+#endif
+
 // A reflection, marshaling and unmarshaling library enable you to manipulate structure (aggregate initializable
-// without empty base classes, const fields, references, or C arrays) elements by index or type and provides other
-// std::tuple like methods for user defined types in a non-intrusive manner without any macro or boilerplate code
+// with at most one non empty base class and without const fields or references) elements by index or type and
+// provides other std::tuple like methods for user defined types in a non-intrusive manner without any macro or
+// boilerplate code
 
 struct W
 {
@@ -47,6 +56,34 @@ struct Y
     X x;
 };
 
+// C arrays and a base class, declared through base_of, whose members come first
+
+struct Header
+{
+    uint32_t seq;
+    char tag[4];
+};
+
+struct Quote : Header
+{
+    double px[2];
+    int64_t qty;
+};
+
+template <>
+struct fmp::base_of<Quote>
+{
+    using type = Header;
+};
+
+// a record that declares no base is bound as a whole, whatever its first member converts from
+
+struct Tagged
+{
+    std::any tag;
+    int id;
+};
+
 // fmp can reflect, marshal and unmarshal fundamental types, UDTS and all STL containers
 // see line 534
 
@@ -138,8 +175,8 @@ int main(int argc, char* argv[])
 
     // get the offset of a field by index
 
-    assert((fmp::offset_of<1, Y>() == 8));
-    assert((fmp::offset_of<2, Y>() == 16));
+    static_assert(fmp::offset_of<1, Y>() == 8);
+    static_assert(fmp::offset_of<2, Y>() == 16);
 
     X x { 21.3f, "metaprogramming" };
     Y y { 2024, 19.04, '*', { 18.47f, "stateful" } };
@@ -190,9 +227,18 @@ int main(int argc, char* argv[])
     fx.f_base::value = 20.44f;
     assert(y.x.f == 20.44f);
 
+    // get the index of a field by member pointer, at compile time by its name
+
     assert(fmp::index(&X::s) == 1);
     assert(fmp::index(&Y::x) == 3);
 
+    assert(fmp::index(&Z::maps) == 13);
+    assert(fmp::index(&Quote::qty) == 3);
+
+    static_assert(fmp::index(&X::s) == 1);
+    static_assert(fmp::index_v<&X::s> == 1);
+    static_assert(fmp::index_v<&Z::maps> == 13);
+
     // get the number of members
 
     static_assert(fmp::arity_v<X> == 2);
@@ -350,6 +396,67 @@ int main(int argc, char* argv[])
     assert(std::get<std::string>(fmp::get<4>(fu0)) == std::get<1>(fmp::get<4>(mf0)));
     assert(fmp::get<1>(std::get<4>(tu0)) == fmp::get<std::string>(std::get<4>(mt0)));
 
+    // ordered containers are decoded with end hinted insertions, flat containers in bulk
+
+#ifdef __cpp_lib_flat_map
+    auto flats = fmp::make_fuple(std::flat_map<int, std::string> { { 1, "one" }, { 2, "two" } },
+                 std::flat_multimap<int, int> { { 3, 1 }, { 3, 2 } }, std::flat_set<std::string> { "fmp", "flat" });
+
+    auto fl = fmp::unmarshal<decltype(flats)>(fmp::marshal(flats));
+
+    assert(fl == flats);
+    assert(fmp::get<0>(fl).keys() == fmp::get<0>(flats).keys());
+#endif
+
+    // a variant is its index followed by its alternative, pairs and tuples by their elements, ranges of
+    // padless structures and pairs of fundamentals are copied as a whole
+
+    using V = std::variant<int, std::string, std::vector<int>>;
+
+    auto vs = fmp::make_fuple(std::vector<V> { 1, "variant", std::vector<int> { 2, 3 } }, std::pair<int, std::string>(4, "pair"),
+              std::make_tuple('t', 5.0), std::vector<std::pair<int, int>> { { 6, 7 }, { 8, 9 } });
+
+    auto vu = fmp::unmarshal<decltype(vs)>(fmp::marshal(vs));
+
+    assert(vu == vs);
+    assert(std::get<std::string>(fmp::get<0>(vu)[1]) == "variant");
+
+    static_assert(fmp::is_dense_v<std::pair<int, int>>);
+    static_assert(!fmp::is_dense_v<std::pair<int, double>>);
+
+    // an array is copied as a whole, with no length, the members of a base come first
+
+    static_assert(fmp::arity_v<Quote> == 4 && fmp::has_base_v<Quote>);
+    static_assert(std::is_same_v<fmp::members_t<Quote>, fmp::fuple<uint32_t, char[4], double[2], int64_t>>);
+
+    static_assert(fmp::member_name_v<1, Quote> == "tag");
+    static_assert(fmp::arity_v<Tagged> == 2 && !fmp::has_base_v<Tagged>);
+    Quote q {};
+    assert((fmp::offset_of<2, Quote>() == reinterpret_cast<char*>(&q.px) - reinterpret_cast<char*>(&q)));
+    assert((fmp::offset_of<3, Quote>() == reinterpret_cast<char*>(&q.qty) - reinterpret_cast<char*>(&q)));
+
+    q.seq = 7;
+    q.qty = 100;
+
+    std::memcpy(q.tag, "AAPL", 4);
+
+    q.px[0] = 1.5;
+    q.px[1] = 2.5;
+
+    auto qs = fmp::marshal(q);
+    assert(qs.size() == sizeof(uint32_t) + 4 + 2 * sizeof(double) + sizeof(int64_t));
+
+    auto qu = fmp::unmarshal<Quote>(qs);
+    assert(qu.seq == 7 && !std::memcmp(qu.tag, "AAPL", 4) && qu.px[1] == 2.5 && qu.qty == 100);
+
+    // a std::array takes no more elements than it holds, the others are skipped
+
+    auto at = std::make_tuple(std::vector<int> { 1, 2, 3, 4, 5 }, 6);
+    auto as = fmp::marshal(at);
+    auto au = fmp::unmarshal<std::tuple<std::array<int, 3>, int>>(as);
+
+    assert((std::get<0>(au) == std::array<int, 3> { 1, 2, 3 } && std::get<1>(au) == 6));
+
     // stream operators
 
     W w1;
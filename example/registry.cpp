@@ -0,0 +1,160 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+// g++ -I include -m64 -std=c++26 -s -Wall -O3 -o /tmp/registry example/registry.cpp
+
+#include <map>
+#include <vector>
+#include <cassert>
+#include <iostream>
+#include <registry.hpp>
+
+// a stream of messages of several types, dispatched by the type id in front of every message
+
+struct Login
+{
+    int user;
+    std::string token;
+};
+
+struct Order
+{
+    int id;
+    double price;
+    long quantity;
+};
+
+struct Cancel
+{
+    int id;
+};
+
+struct Book
+{
+    std::map<double, long> bids;
+    std::vector<Order> orders;
+};
+
+struct Unknown
+{
+    int x;
+};
+
+template <>
+consteval uint64_t fmp::type_id<Cancel>()
+{
+    return 42;
+}
+
+template <typename... Fs>
+struct overload : Fs...
+{
+    using Fs::operator()...;
+};
+
+int main(int argc, char* argv[])
+{
+    using messages = fmp::registry<Login, Order, Cancel, Book>;
+
+    static_assert(messages::index_v<Login> == 0);
+    static_assert(messages::index_v<Book> == 3);
+    static_assert(messages::index_v<Unknown> == fmp::npos);
+
+    // ids may be pinned
+
+    static_assert(fmp::type_id_v<Cancel> == 42);
+    static_assert(messages::index(42) == 2);
+
+    std::string s;
+
+    messages::marshal(s, Login { 7, "secret" });
+    messages::marshal(s, Order { 1, 99.5, 100 });
+    messages::marshal(s, Cancel { 1 });
+    messages::marshal(s, Book { { { 99.5, 100 }, { 99.0, 200 } }, { { 2, 98.5, 10 } } });
+
+    size_t n = fmp::size_bytes(Login { 7, "secret" });
+    assert(s.size() > n + sizeof(uint64_t));
+
+    // dispatch to the overload of each type
+
+    size_t l = 0;
+    std::vector<size_t> seen;
+
+    auto f = overload
+    {
+        [&](const Login& m){ assert(m.user == 7 && m.token == "secret"); seen.push_back(0); },
+        [&](const Order& m){ assert(m.id == 1 && m.price == 99.5 && m.quantity == 100); seen.push_back(1); },
+        [&](const Cancel& m){ assert(m.id == 1); seen.push_back(2); },
+        [&](const Book& m){ assert(m.bids.size() == 2 && m.orders[0].id == 2); seen.push_back(3); }
+    };
+
+    while (l != s.size())
+         assert(messages::dispatch(l, s, f));
+
+    assert((seen == std::vector<size_t>{ 0, 1, 2, 3 }));
+
+    // decode into a variant in place and visit it
+
+    l = 0;
+    messages::variant v;
+
+    std::vector<size_t> indices;
+
+    while (l != s.size())
+    {
+         assert(messages::decode(l, s, v));
+         indices.push_back(v.index());
+
+         std::visit(f, v);
+    }
+
+    assert((indices == std::vector<size_t>{ 0, 1, 2, 3 }));
+
+    // a message of the type held already replaces it, with or without reuse
+
+    std::string w;
+
+    messages::marshal(w, Book { { { 99.5, 100 }, { 99.0, 200 } }, {} });
+    messages::marshal(w, Book { { { 99.5, 300 }, { 98.0, 400 } }, {} });
+
+    for (int i = 0; i != 2; ++i)
+    {
+         l = 0;
+
+         for (size_t k = 0; k != 2; ++k)
+         {
+              assert(i ? messages::decode(l, w, v, fmp::reuse()) : messages::decode(l, w, v));
+              assert(std::get<Book>(v).bids.size() == 2 && std::get<Book>(v).bids[99.5] == long(100 + 200 * k));
+         }
+
+         assert(!std::get<Book>(v).bids.contains(99.0) && std::get<Book>(v).bids[98.0] == 400);
+    }
+
+    // an unregistered type is reported and skipped past its id
+
+    std::string u;
+    fmp::registry<Unknown>::marshal(u, Unknown { 3 });
+
+    l = 0;
+    assert(!messages::dispatch(l, u, f));
+    assert(l == sizeof(uint64_t));
+
+    // the policies apply to the ids as well
+
+    std::string b;
+    messages::marshal(b, Order { 5, 1.5, 2 }, fmp::big_endian());
+
+    l = 0;
+    assert(messages::decode(l, b, v, fmp::big_endian()));
+    assert(std::get<Order>(v).id == 5);
+
+    std::cout << messages::size << " types in " << (1 << messages::bits) << " slots" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,198 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+// g++ -I include -m64 -std=c++26 -s -Wall -O3 -o /tmp/rpc example/rpc.cpp
+
+#include <map>
+#include <thread>
+#include <vector>
+#include <cassert>
+#include <iostream>
+#include <rpc.hpp>
+
+// request and response over unix domain sockets
+
+struct Req
+{
+    int a;
+    int b;
+    std::string s;
+    std::map<std::string, int> opts;
+};
+
+struct Resp
+{
+    long v;
+    std::string s;
+};
+
+Resp add(const Req& r)
+{
+    return { r.a + r.b, r.s };
+}
+
+Resp mul(const Req& r)
+{
+    return { long(r.a) * r.b, r.s + r.s };
+}
+
+Resp unbound(const Req& r)
+{
+    return {};
+}
+
+Resp options(const Req& r)
+{
+    std::string s;
+
+    for (auto& [k, v] : r.opts)
+         s += k + '=' + std::to_string(v) + ';';
+
+    return { long(r.opts.size()), s };
+}
+
+int main(int argc, char* argv[])
+{
+    static_assert(fmp::rpc::method_v<add> != fmp::rpc::method_v<mul>);
+
+    // a socketpair, the server runs on its own thread
+
+    {
+        auto [a, b] = fmp::rpc::pair();
+        assert(a >= 0 && b >= 0);
+
+        std::thread t([fd = b]
+        {
+            fmp::rpc::server<Req, Resp> s(fd);
+
+            s.bind<add>();
+            s.bind<mul>();
+            s.bind<options>();
+
+            s.run();
+        });
+
+        {
+            fmp::rpc::client<Req, Resp> c(a);
+
+            // a round trip
+
+            Resp r = *c.call<add>({ 2, 3, "sum" });
+
+            assert(r.v == 5);
+            assert(r.s == "sum");
+
+            r = *c.call<mul>({ 2, 3, "ab" });
+
+            assert(r.v == 6);
+            assert(r.s == "abab");
+
+            // pipelined requests go out with a single send
+
+            size_t syscalls = c.syscalls;
+
+            for (int i = 0; i != 100; ++i)
+                 c.send<add>({ i, i, "" });
+
+            c.flush();
+            assert(c.syscalls == syscalls + 1);
+
+            for (uint64_t i = 0, id = 0; i != 100; ++i)
+            {
+                 assert(c.recv(id, r));
+                 assert(id == c.last - 99 + i);
+                 assert(r.v == long(2 * i));
+            }
+
+            // an unbound method is answered with a default response
+
+            r = *c.call<unbound>({ 1, 1, "" });
+            assert(!c.handled);
+
+            // a request keeps nothing of the one before
+
+            r = *c.call<options>({ 0, 0, "", { { "a", 1 }, { "b", 2 } } });
+            assert(r.v == 2 && r.s == "a=1;b=2;");
+
+            r = *c.call<options>({ 0, 0, "", { { "b", 3 } } });
+            assert(r.v == 1 && r.s == "b=3;");
+        }
+
+        t.join();
+    }
+
+    // a named socket
+
+    {
+        std::string path = "/tmp/fmp_rpc.sock";
+
+        int l = fmp::rpc::listen(path);
+        assert(l >= 0);
+
+        std::thread t([&]
+        {
+            fmp::rpc::server<Req, Resp> s(fmp::rpc::accept(l));
+
+            s.bind<mul>();
+            s.run();
+        });
+
+        {
+            fmp::rpc::client<Req, Resp> c(fmp::rpc::connect(path));
+
+            Resp r = *c.call<mul>({ 6, 7, "x" });
+
+            assert(r.v == 42);
+            std::cout << r.v << ' ' << r.s << std::endl;
+        }
+
+        t.join();
+
+        // a closed connection gives no response rather than a default one
+
+        {
+            fmp::rpc::client<Req, Resp> c(fmp::rpc::connect(path));
+            ::close(fmp::rpc::accept(l));
+
+            assert(!c.call<mul>({ 6, 7, "x" }));
+        }
+
+        ::close(l);
+        ::unlink(path.c_str());
+    }
+
+    // a frame shorter than its header, or whose payload does not end with it, breaks the connection
+
+    for (uint32_t extra : { 0u, 3u })
+    {
+         auto [a, b] = fmp::rpc::pair();
+
+         fmp::rpc::channel c(a);
+         ::close(b);
+
+         std::string payload = fmp::marshal(Req { 1, 2, "x" });
+         uint32_t length = extra ? 2 * sizeof(uint64_t) + payload.size() + extra : 4;
+
+         c.in.append(reinterpret_cast<const char*>(&length), sizeof(length));
+         c.in.append(2 * sizeof(uint64_t) + payload.size() + extra, '\0');
+
+         if (extra)
+             c.in.replace(fmp::rpc::header_size, payload.size(), payload);
+
+         uint64_t id;
+         uint64_t method;
+
+         Req r {};
+
+         assert(!c.take(id, method, r) && c.broken);
+         assert(!c.get(id, method, r));
+    }
+
+    return 0;
+}
@@ -0,0 +1,131 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+// g++ -I include -m64 -std=c++26 -s -Wall -O3 -o /tmp/tracked example/tracked.cpp
+
+#include <vector>
+#include <cassert>
+#include <iostream>
+#include <tracked.hpp>
+
+// publish the members written since the last patch, without a copy to diff against
+
+struct X
+{
+    float f;
+    std::string s;
+};
+
+struct Quote
+{
+    int id;
+    double bid;
+    double ask;
+    long volume;
+    X x;
+    std::string venue;
+    std::vector<int> levels;
+};
+
+int main(int argc, char* argv[])
+{
+    Quote q { 7, 99.5, 100.5, 1000, { 1.5f, "nested" }, "XNAS", { 1, 2, 3 } };
+
+    fmp::tracked<Quote> t(q);
+    assert(!t.dirty());
+
+    // nothing written, a patch is the bitmask only
+
+    assert(t.marshal_dirty().size() == 1);
+
+    // members are written through proxies, by index or by name
+
+    fmp::get<1>(t) = 99.75;
+    t.get<fmp::member_index<Quote>("volume")>() = 1200L;
+
+    assert(t.dirty(1));
+    assert(t.dirty(3));
+    assert(!t.dirty(2));
+
+    double bid = t.get<1>();
+    assert(bid == 99.75);
+    assert(t->volume == 1200);
+
+    auto p = t.marshal_dirty();
+    assert(p.size() == 1 + sizeof(double) + sizeof(long));
+
+    // the receiver applies the patch to its own copy
+
+    Quote r = q;
+    fmp::apply_patch(r, p);
+
+    assert(fmp::same(r, *t));
+
+    // the marks stay until cleared
+
+    assert(t.dirty());
+    t.clear();
+
+    assert(!t.dirty());
+    assert(t.marshal_dirty().size() == 1);
+
+    // containers and nested records are modified in place through the arrow
+
+    t.get<6>()->push_back(4);
+    t.get<4>()->s = "changed";
+
+    fmp::apply_patch(r, t.marshal_dirty());
+    assert(fmp::same(r, *t));
+
+    assert(r.levels.size() == 4);
+    assert(r.x.s == "changed");
+
+    // scalars are updated in place by compound assignments, increments and decrements
+
+    t.clear();
+
+    fmp::get<3>(t) += 300;
+    ++fmp::get<0>(t);
+
+    assert(t.get<0>()-- == 8);
+    assert(t.dirty(0) && t.dirty(3) && !t.dirty(1));
+
+    t.get<1>() *= 2;
+    t.get<3>() >>= 1;
+
+    fmp::apply_patch(r, t.marshal_dirty());
+
+    assert(r.id == 7 && r.bid == 199.5 && r.volume == 750);
+    assert(fmp::same(r, *t));
+
+    // patches of several updates are applied in turn
+
+    t.clear();
+
+    std::string s;
+    t.get<5>() = "XNYS";
+
+    t.marshal_dirty(s);
+    t.clear();
+
+    t.get<2>() = 101.0;
+    t.marshal_dirty(s, fmp::big_endian());
+
+    size_t l = 0;
+
+    fmp::apply_patch(l, s, r, fmp::policy());
+    fmp::apply_patch(l, s, r, fmp::big_endian());
+
+    assert(l == s.size());
+    assert(fmp::same(r, *t));
+
+    std::cout << r.venue << ' ' << r.ask << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,416 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+#ifndef COMPRESS_HPP
+#define COMPRESS_HPP
+
+#include <bit>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <reflect.hpp>
+
+namespace fmp
+{
+    // an lz77 block codec tuned for speed over ratio, a block is a run of sequences of
+    // [token][literal length][literals][offset][match length], the high nibble of the token is the
+    // literal length and the low one the match length minus 4, a nibble of 15 is continued by bytes
+    // of 255 and a final byte, the offset takes 2 bytes, the last sequence has literals only
+
+    inline constexpr size_t compress_bound(size_t size)
+    {
+        return size + size / 255 + 16;
+    }
+
+    namespace lz
+    {
+        inline constexpr size_t min_match = 4;
+        inline constexpr size_t hash_log = 12;
+
+        inline uint32_t load32(const unsigned char* p)
+        {
+            uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+
+            return v;
+        }
+
+        inline uint64_t load64(const unsigned char* p)
+        {
+            uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+
+            return v;
+        }
+
+        inline unsigned char* length(unsigned char* op, size_t n)
+        {
+            for (; n >= 255; n -= 255)
+                 *op++ = 255;
+
+            *op++ = n;
+
+            return op;
+        }
+
+        inline unsigned char* literals(unsigned char* op, const unsigned char* anchor, size_t n, unsigned char token)
+        {
+            *op++ = std::min<size_t>(n, 15) << 4 | token;
+
+            if (n >= 15)
+                op = length(op, n - 15);
+
+            std::memcpy(op, anchor, n);
+
+            return op + n;
+        }
+
+        inline size_t count(const unsigned char* ip, const unsigned char* ref, const unsigned char* limit)
+        {
+            auto start = ip;
+
+            while (ip + 8 <= limit)
+            {
+                 if (uint64_t x = load64(ip) ^ load64(ref))
+                     return ip - start + (std::endian::native == std::endian::little ? std::countr_zero(x) : std::countl_zero(x)) / 8;
+
+                 ip += 8;
+                 ref += 8;
+            }
+
+            while (ip < limit && *ip == *ref)
+            {
+                 ++ip;
+                 ++ref;
+            }
+
+            return ip - start;
+        }
+
+        template <size_t N>
+        inline void copy(unsigned char* op, const unsigned char* ip, size_t n)
+        {
+            for (size_t i = 0; i < n; i += N)
+                 std::memcpy(op + i, ip + i, N);
+        }
+    }
+
+    // compress size bytes of src into dst, which must hold compress_bound(size) bytes, return the size
+    // of the block
+
+    inline size_t compress(const void* src, size_t size, void* dst)
+    {
+        using namespace lz;
+
+        auto base = static_cast<const unsigned char*>(src);
+        auto op = static_cast<unsigned char*>(dst);
+
+        auto ip = base;
+        auto anchor = base;
+
+        auto end = base + size;
+
+        if (size > 12)
+        {
+            uint32_t table[1 << hash_log] {};
+
+            auto limit = end - 12;
+            auto match = end - 5;
+
+            while (ip < limit)
+            {
+                 uint32_t v = load32(ip);
+                 uint32_t h = v * 2654435761u >> (32 - hash_log);
+
+                 auto ref = base + table[h];
+                 table[h] = ip - base;
+
+                 if (ref >= ip || ip - ref > 65535 || load32(ref) != v)
+                 {
+                     ip += 1 + ((ip - anchor) >> 6);
+
+                     continue;
+                 }
+
+                 while (ip > anchor && ref > base && ip[-1] == ref[-1])
+                 {
+                      --ip;
+                      --ref;
+                 }
+
+                 size_t n = min_match + count(ip + min_match, ref + min_match, match);
+                 size_t m = n - min_match;
+
+                 op = literals(op, anchor, ip - anchor, std::min<size_t>(m, 15));
+
+                 size_t offset = ip - ref;
+
+                 *op++ = offset;
+                 *op++ = offset >> 8;
+
+                 if (m >= 15)
+                     op = length(op, m - 15);
+
+                 ip += n;
+                 anchor = ip;
+
+                 if (ip < limit)
+                     table[load32(ip - 2) * 2654435761u >> (32 - hash_log)] = ip - 2 - base;
+            }
+        }
+
+        op = literals(op, anchor, end - anchor, 0);
+
+        return op - static_cast<unsigned char*>(dst);
+    }
+
+    // decompress a block of size bytes into dst of capacity bytes, return the size of the output or
+    // npos if the block is malformed, it never reads or writes out of the bounds
+
+    inline size_t decompress(const void* src, size_t size, void* dst, size_t capacity)
+    {
+        using namespace lz;
+
+        auto ip = static_cast<const unsigned char*>(src);
+        auto op = static_cast<unsigned char*>(dst);
+
+        auto iend = ip + size;
+        auto oend = op + capacity;
+
+        auto base = op;
+
+        auto extend = [&](size_t& n)
+        {
+            if (n != 15)
+                return true;
+
+            for (unsigned char c = 255; c == 255; n += c)
+            {
+                 if (ip == iend)
+                     return false;
+
+                 c = *ip++;
+            }
+
+            return true;
+        };
+
+        while (ip < iend)
+        {
+            unsigned char token = *ip++;
+            size_t n = token >> 4;
+
+            if (!extend(n) || n > size_t(iend - ip) || n > size_t(oend - op))
+                return npos;
+
+            if (size_t(iend - ip) >= n + 16 && size_t(oend - op) >= n + 16)
+                copy<16>(op, ip, n);
+            else
+                std::memcpy(op, ip, n);
+
+            ip += n;
+            op += n;
+
+            if (ip == iend)
+                break;
+
+            if (iend - ip < 2)
+                return npos;
+
+            size_t offset = ip[0] | ip[1] << 8;
+            ip += 2;
+
+            n = token & 15;
+
+            if (!extend(n))
+                return npos;
+
+            n += min_match;
+
+            if (!offset || offset > size_t(op - base) || n > size_t(oend - op))
+                return npos;
+
+            auto ref = op - offset;
+
+            if (offset >= 16 && size_t(oend - op) >= n + 16)
+                copy<16>(op, ref, n);
+            else if (offset >= 8 && size_t(oend - op) >= n + 8)
+                copy<8>(op, ref, n);
+            else if (size_t(oend - op) >= n + 16)
+            {
+                // repeat the short pattern over 16 bytes, then copy from a multiple of the offset
+
+                for (size_t i = 0; i != 16; ++i)
+                     op[i] = ref[i];
+
+                if (n > 16)
+                    copy<8>(op + 16, op + 16 - offset * (16 / offset), n - 16);
+            }
+            else
+            {
+                for (size_t i = 0; i != n; ++i)
+                     op[i] = ref[i];
+            }
+
+            op += n;
+        }
+
+        return op - base;
+    }
+
+    // batches of messages, the messages are marshaled into chunks of about chunk bytes, every chunk is
+    // stored as [raw size:u32][block size:u32][block], or raw when it does not shrink, a message never
+    // spans two chunks, so the reader decompresses a chunk at a time and unmarshals from it directly
+
+    struct batch_writer
+    {
+        explicit batch_writer(size_t chunk = 1 << 16) : chunk(chunk)
+        {
+        }
+
+        template <typename T, typename P>
+        requires is_policy_v<P>
+        void write(T&& t, P&& p)
+        {
+            buff.clear();
+            marshal(buff, std::forward<T>(t), std::forward<P>(p));
+
+            block += buff;
+
+            if (block.size() >= chunk)
+                flush();
+        }
+
+        template <typename T>
+        void write(T&& t)
+        {
+            write(std::forward<T>(t), policy());
+        }
+
+        void flush()
+        {
+            if (block.empty())
+                return;
+
+            size_t l = out.size();
+            out.resize(l + 8 + compress_bound(block.size()));
+
+            auto data = out.data() + l + 8;
+            uint32_t size = compress(block.data(), block.size(), data);
+
+            if (size >= block.size())
+            {
+                size = block.size();
+                std::memcpy(data, block.data(), size);
+            }
+
+            put(l, block.size());
+            put(l + 4, size);
+
+            out.resize(l + 8 + size);
+            block.clear();
+        }
+
+        const std::string& str()
+        {
+            flush();
+
+            return out;
+        }
+
+        void put(size_t l, uint32_t v)
+        {
+            if constexpr(std::endian::native == std::endian::big)
+                v = std::byteswap(v);
+
+            std::memcpy(out.data() + l, &v, sizeof(v));
+        }
+
+        size_t chunk;
+
+        std::string out;
+        std::string block;
+        std::string buff;
+    };
+
+    struct batch_reader
+    {
+        explicit batch_reader(std::string_view in) : in(in)
+        {
+        }
+
+        // unmarshal the next message into t, return false at the end of the input or on a malformed chunk
+
+        template <typename T, typename P>
+        requires is_policy_v<P>
+        bool read(T&& t, P&& p)
+        {
+            if (l == block.size() && !next())
+                return false;
+
+            unmarshal(l, block, std::forward<T>(t), std::forward<P>(p));
+
+            return true;
+        }
+
+        template <typename T>
+        bool read(T&& t)
+        {
+            return read(std::forward<T>(t), policy());
+        }
+
+        bool next()
+        {
+            if (in.size() < 8)
+                return false;
+
+            uint32_t raw = get(0);
+            uint32_t size = get(4);
+
+            corrupted = in.size() - 8 < size;
+
+            if (corrupted)
+                return false;
+
+            block.resize(raw);
+
+            if (size == raw)
+                std::memcpy(block.data(), in.data() + 8, size);
+            else
+                corrupted = decompress(in.data() + 8, size, block.data(), raw) != raw;
+
+            if (corrupted)
+                return false;
+
+            in.remove_prefix(8 + size);
+            l = 0;
+
+            return raw || next();
+        }
+
+        uint32_t get(size_t l) const
+        {
+            uint32_t v;
+            std::memcpy(&v, in.data() + l, sizeof(v));
+
+            if constexpr(std::endian::native == std::endian::big)
+                v = std::byteswap(v);
+
+            return v;
+        }
+
+        std::string_view in;
+        std::string block;
+
+        size_t l = 0;
+        bool corrupted = false;
+    };
+}
+
+#endif
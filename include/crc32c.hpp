@@ -0,0 +1,95 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+#ifndef CRC32C_HPP
+#define CRC32C_HPP
+
+#include <bit>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace fmp
+{
+    // tables of the reflected Castagnoli polynomial for the slicing by 8 fallback
+
+    inline constexpr auto crc32c_table = []
+    {
+        std::array<std::array<uint32_t, 256>, 8> t {};
+
+        for (uint32_t i = 0; i != 256; ++i)
+        {
+             uint32_t c = i;
+
+             for (int k = 0; k != 8; ++k)
+                  c = c & 1 ? c >> 1 ^ 0x82f63b78 : c >> 1;
+
+             t[0][i] = c;
+        }
+
+        for (size_t k = 1; k != 8; ++k)
+        {
+             for (size_t i = 0; i != 256; ++i)
+                  t[k][i] = t[k - 1][i] >> 8 ^ t[0][t[k - 1][i] & 0xff];
+        }
+
+        return t;
+    }();
+
+    // the crc32c of size bytes, continuing from crc, so that crc32c(b, m, crc32c(a, n)) is the crc32c of
+    // a followed by b, computed with the crc32 instructions of sse4.2 or armv8 when they are enabled
+
+    inline uint32_t crc32c(const void* data, size_t size, uint32_t crc = 0)
+    {
+        auto p = static_cast<const unsigned char*>(data);
+        uint64_t c = ~crc;
+
+        for (; size >= 8; size -= 8, p += 8)
+        {
+             uint64_t v;
+             std::memcpy(&v, p, 8);
+
+#if defined(__SSE4_2__)
+             c = _mm_crc32_u64(c, v);
+#elif defined(__ARM_FEATURE_CRC32)
+             c = __crc32cd(c, v);
+#else
+             if constexpr(std::endian::native == std::endian::big)
+                 v = std::byteswap(v);
+
+             v ^= c;
+             auto& t = crc32c_table;
+
+             c = t[7][v & 0xff] ^ t[6][v >> 8 & 0xff] ^ t[5][v >> 16 & 0xff] ^ t[4][v >> 24 & 0xff] ^
+                 t[3][v >> 32 & 0xff] ^ t[2][v >> 40 & 0xff] ^ t[1][v >> 48 & 0xff] ^ t[0][v >> 56];
+#endif
+        }
+
+        for (; size; --size, ++p)
+        {
+#if defined(__SSE4_2__)
+             c = _mm_crc32_u8(c, *p);
+#elif defined(__ARM_FEATURE_CRC32)
+             c = __crc32cb(c, *p);
+#else
+             c = crc32c_table[0][(c ^ *p) & 0xff] ^ c >> 8;
+#endif
+        }
+
+        return ~uint32_t(c);
+    }
+}
+
+#endif
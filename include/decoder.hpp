@@ -0,0 +1,705 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+#ifndef DECODER_HPP
+#define DECODER_HPP
+
+#include <new>
+#include <vector>
+#include <memory>
+#include <reflect.hpp>
+
+namespace fmp
+{
+    enum class progress
+    {
+        more,
+        done
+    };
+
+    // a resumable unmarshaler, it decodes a message of the plain wire format into t as its bytes
+    // arrive, the position inside nested records, containers and strings is kept on a stack of
+    // frames, so no byte is decoded twice, strings and contiguous ranges of fundamentals are
+    // copied into place as far as they have arrived, and only the head of a fundamental split across
+    // two chunks is buffered, a policy may give the byte order and the reuse of the existing objects
+
+    template <typename T, typename P = policy>
+    struct decoder
+    {
+        static_assert(! requires (P p) { p.rejected; } && ! requires (P p) { p.corrupted; } && ! requires { requires P::tagging; },
+                      "the decoder takes the plain wire format only");
+
+        static_assert(! requires (P p) { p.resource; } && ! requires (P p) { p.leave(0); },
+                      "the decoder takes neither an arena nor a profiler");
+
+        enum
+        {
+            wait,
+            pop
+        };
+
+        struct frame
+        {
+            int (*step)(decoder&, frame&);
+            void* t;
+
+            size_t k = 0;
+            size_t i = 0;
+            size_t n = 0;
+
+            // the iterator of a list, the entry and the recycled nodes of an associative container
+
+            alignas(void*) unsigned char it[2 * sizeof(void*)];
+            std::unique_ptr<void, void(*)(void*)> state { nullptr, nullptr };
+        };
+
+        explicit decoder(T& t, P = P())
+        {
+            start(t);
+        }
+
+        // decode the next message into t, starting with the bytes left over from the previous one
+
+        progress start(T& t)
+        {
+            frames.clear();
+            push(t);
+
+            std::string s = std::move(in);
+            in.clear();
+
+            return feed(s.data(), s.size());
+        }
+
+        // take the next chunk of bytes, the bytes past the end of the message are kept for the next one
+
+        progress feed(const void* data, size_t size)
+        {
+            auto s = static_cast<const char*>(data);
+
+            // complete the fundamental split across the chunks a few bytes at a time, then go on
+            // decoding from the chunk itself
+
+            while (!in.empty() && size && !frames.empty())
+            {
+                size_t n = std::min(size, sizeof(uint64_t));
+
+                in.append(s, n);
+                run(in.data(), in.size());
+
+                in.erase(0, l);
+
+                s += n;
+                size -= n;
+            }
+
+            if (in.empty())
+            {
+                run(s, size);
+                in.assign(s + l, size - l);
+            }
+            else
+                in.append(s, size);
+
+            return frames.empty() ? progress::done : progress::more;
+        }
+
+        bool done() const noexcept
+        {
+            return frames.empty();
+        }
+
+        // the number of bytes buffered, a partial fundamental or the bytes past the end of the message
+
+        size_t pending() const noexcept
+        {
+            return in.size();
+        }
+
+        template <typename U>
+        void push(U& u)
+        {
+            frames.push_back({ &step<std::remove_cvref_t<U>>, (void*)std::addressof(u) });
+        }
+
+        template <typename U>
+        bool read(U& u)
+        {
+            if (size - l < sizeof(U))
+                return false;
+
+            std::memcpy((void*)std::addressof(u), data + l, sizeof(U));
+            l += sizeof(U);
+
+            if constexpr(sizeof(U) > 1 && requires { requires P::order != std::endian::native; })
+                byteswap<sizeof(U)>((void*)std::addressof(u), 1);
+
+            return true;
+        }
+
+        template <typename U, typename... Args>
+        static auto make_state(Args&&... args)
+        {
+            return std::unique_ptr<void, void(*)(void*)>(new U(std::forward<Args>(args)...), [](void* v){ delete static_cast<U*>(v); });
+        }
+
+        // decode t depth first as far as the bytes go, return whether it is complete, the frames of an
+        // incomplete t are left on the stack, under the frames of its incomplete members, the frames only
+        // materialize where the bytes run out, so a message that has arrived decodes at about the pace
+        // of unmarshal
+
+        template <typename U>
+        static bool descend(decoder& d, U& t)
+        {
+            if constexpr(std::is_enum_v<U> || std::is_fundamental_v<U>)
+            {
+                if (d.read(t))
+                    return true;
+
+                d.push(t);
+
+                return false;
+            }
+            else
+            {
+                // a string or range of fundamentals wholly arrived is copied straight
+
+                if constexpr(bulk<U>)
+                {
+                    using V = std::remove_cvref_t<decltype(*t.data())>;
+
+                    size_t n = 0;
+                    size_t l = d.l;
+
+                    if (d.read(n) && (d.size - d.l) / sizeof(V) >= n)
+                    {
+                        size_t m = n;
+
+                        if constexpr(requires { t.resize(0); })
+                            t.resize(n);
+                        else
+                            m = std::min<size_t>(n, t.size());
+
+                        if (m)
+                            std::memcpy((void*)t.data(), d.data + d.l, m * sizeof(V));
+
+                        d.l += n * sizeof(V);
+
+                        if constexpr(sizeof(V) > 1 && requires { requires P::order != std::endian::native; })
+                            byteswap<sizeof(V)>((void*)t.data(), m);
+
+                        return true;
+                    }
+
+                    d.l = l;
+                }
+
+                size_t mark = d.frames.size();
+
+                // a record needs a frame only once it is incomplete
+
+                if constexpr(is_record_v<U>)
+                {
+                    size_t i = 0;
+
+                    if (members(d, t, i))
+                        return true;
+
+                    frame f { &step<U>, (void*)std::addressof(t) };
+                    f.i = i;
+
+                    d.frames.insert(d.frames.begin() + mark, std::move(f));
+
+                    return false;
+                }
+
+                frame f { &step<U>, (void*)std::addressof(t) };
+
+                if (resume<U>(d, f) == pop)
+                    return true;
+
+                d.frames.insert(d.frames.begin() + mark, std::move(f));
+
+                return false;
+            }
+        }
+
+        template <typename U>
+        static int step(decoder& d, frame& f)
+        {
+            return resume<U>(d, f);
+        }
+
+        // go on decoding the object of f, it returns pop when the object is complete and wait when the
+        // bytes run out, f may be on the stack, so it is not touched after a member has been descended
+        // into incompletely, the progress is recorded in f before descending
+
+        template <typename U>
+        static int resume(decoder& d, frame& f)
+        {
+            U& t = *static_cast<U*>(f.t);
+
+            if constexpr(std::is_enum_v<U> || std::is_fundamental_v<U>)
+                return d.read(t) ? pop : wait;
+            else if constexpr(std::is_pointer_v<U> || requires { typename U::weak_type; })
+            {
+                if (f.k)
+                    return pop;
+
+                using E = std::remove_cvref_t<decltype(*t)>;
+
+                bool reuse = false;
+
+                // with reuse a non null raw pointer must own a valid object, it is decoded into rather
+                // than replaced, a pointer left indeterminate is dereferenced
+
+                if constexpr(requires { requires P::recycle; })
+                {
+                    if constexpr(std::is_pointer_v<U>)
+                        reuse = t;
+                    else
+                        reuse = t.use_count() == 1;
+                }
+
+                if (!reuse)
+                {
+                    if constexpr(std::is_pointer_v<U>)
+                        t = new E();
+                    else
+                        t = std::make_shared<E>();
+                }
+
+                f.k = 1;
+
+                return descend(d, *t) ? pop : wait;
+            }
+            else if constexpr(requires { t.has_value(); })
+            {
+                if (f.k)
+                    return pop;
+
+                bool engaged = false;
+
+                if (!d.read(engaged))
+                    return wait;
+
+                if (!engaged)
+                {
+                    t.reset();
+
+                    return pop;
+                }
+
+                if constexpr(requires { requires P::recycle; })
+                {
+                    if (!t)
+                        t.emplace();
+                }
+                else
+                    t = typename U::value_type();
+
+                f.k = 1;
+
+                return descend(d, *t) ? pop : wait;
+            }
+            else if constexpr(is_variant_v<U>)
+            {
+                if (f.k)
+                    return pop;
+
+                uint32_t index = 0;
+
+                if (!d.read(index))
+                    return wait;
+
+                constexpr auto table = []<size_t... N>(std::index_sequence<N...>)
+                {
+                    return std::array{ &alternative<U, N>... };
+                }
+                (std::make_index_sequence<std::variant_size_v<U>>());
+
+                f.k = 1;
+
+                if (index < table.size())
+                    return table[index](d, t) ? pop : wait;
+
+                if constexpr(std::is_default_constructible_v<U>)
+                    t = U();
+
+                return pop;
+            }
+            else if constexpr(std::is_array_v<U>)
+                return array(d, f, t);
+            else if constexpr(requires { t.begin(); t.end(); })
+                return range(d, f, t);
+            else if constexpr(std::is_class_v<U>)
+                return members(d, t, f.i) ? pop : wait;
+            else
+                return pop;
+        }
+
+        template <typename U, size_t N>
+        static bool alternative(decoder& d, U& t)
+        {
+            if constexpr(requires { requires P::recycle; })
+            {
+                if (t.index() != N)
+                    t.template emplace<N>();
+            }
+            else
+                t.template emplace<N>();
+
+            return descend(d, *std::get_if<N>(&t));
+        }
+
+        // the members of a record from the i-th on, i is advanced past a member before descending into it
+
+        template <typename U>
+        static bool members(decoder& d, U& t, size_t& i)
+        {
+            bool complete = true;
+
+            [&]<size_t... N>(std::index_sequence<N...>)
+            {
+                auto r = fields(t);
+                ((complete = complete && (N < i || (i = N + 1, descend(d, fmp::get<N>(r))))), ...);
+            }
+            (std::make_index_sequence<fields_v<U>>());
+
+            return complete;
+        }
+
+        // an array has no length, i counts the bytes copied of an array copied whole, the elements of
+        // the others
+
+        template <typename U>
+        static int array(decoder& d, frame& f, U& t)
+        {
+            using E = std::remove_all_extents_t<U>;
+
+            if constexpr(std::is_enum_v<E> || std::is_fundamental_v<E> || (is_dense_v<E> && ! requires { requires P::order != std::endian::native; }))
+            {
+                size_t m = std::min(sizeof(U) - f.i, d.size - d.l);
+
+                if (m)
+                    std::memcpy((char*)t + f.i, d.data + d.l, m);
+
+                d.l += m;
+                f.i += m;
+
+                if (f.i != sizeof(U))
+                    return wait;
+
+                if constexpr((std::is_enum_v<E> || std::is_fundamental_v<E>) && sizeof(E) > 1 && requires { requires P::order != std::endian::native; })
+                    byteswap<sizeof(E)>((void*)t, sizeof(U) / sizeof(E));
+
+                return pop;
+            }
+            else
+            {
+                while (f.i != std::extent_v<U>)
+                {
+                    if (!descend(d, t[f.i++]))
+                        return wait;
+                }
+
+                return pop;
+            }
+        }
+
+        template <typename U>
+        static int range(decoder& d, frame& f, U& t)
+        {
+            if (f.k == 0)
+            {
+                size_t n = 0;
+
+                if (!d.read(n))
+                    return wait;
+
+                f.k = 1;
+                f.n = n;
+
+                if constexpr(bulk<U>)
+                {
+                    if constexpr(requires { t.resize(0); })
+                        t.resize(n);
+
+                    f.n = n * sizeof(*t.data());
+                }
+                else if constexpr(! requires { typename U::key_type; typename U::value_type; })
+                {
+                    using I = decltype(t.begin());
+
+                    // the elements past the end of a range that cannot be resized are decoded into a scratch
+                    // element and dropped
+
+                    if constexpr(requires { t.resize(0); })
+                        t.resize(n);
+                    else if (n > size_t(std::distance(t.begin(), t.end())))
+                        f.state = make_state<std::remove_cvref_t<decltype(*t.begin())>>();
+
+                    if constexpr(!std::random_access_iterator<I>)
+                    {
+                        static_assert(sizeof(I) <= sizeof(f.it) && std::is_trivially_copyable_v<I>);
+                        new (f.it) I(t.begin());
+                    }
+                }
+                else
+                {
+                    f.state = make_state<scratch<U>>();
+
+                    if constexpr(recyclable<U>)
+                    {
+                        auto& c = *static_cast<scratch<U>*>(f.state.get());
+
+                        c.nodes = std::move(t);
+                        t.clear();
+
+                        if constexpr(requires { t.reserve(n); })
+                            t.reserve(n);
+                    }
+                }
+            }
+
+            if constexpr(bulk<U>)
+            {
+                using V = std::remove_cvref_t<decltype(*t.data())>;
+
+                size_t m = std::min(f.n - f.i, d.size - d.l);
+                size_t c = f.n;
+
+                if constexpr(! requires { t.resize(0); })
+                    c = std::min(f.n, t.size() * sizeof(V));
+
+                if (f.i < c)
+                    std::memcpy((char*)t.data() + f.i, d.data + d.l, std::min(m, c - f.i));
+
+                d.l += m;
+                f.i += m;
+
+                if (f.i != f.n)
+                    return wait;
+
+                if constexpr(sizeof(V) > 1 && requires { requires P::order != std::endian::native; })
+                    byteswap<sizeof(V)>((void*)t.data(), c / sizeof(V));
+
+                return pop;
+            }
+            else if constexpr(! requires { typename U::key_type; typename U::value_type; })
+            {
+                using I = decltype(t.begin());
+
+                while (f.i != f.n)
+                {
+                    if constexpr(std::random_access_iterator<I> && requires { t.resize(0); })
+                    {
+                        if (!descend(d, t.begin()[f.i++]))
+                            return wait;
+                    }
+                    else if constexpr(std::random_access_iterator<I>)
+                    {
+                        using E = std::remove_cvref_t<decltype(*t.begin())>;
+
+                        size_t i = f.i++;
+
+                        if (!descend(d, i < size_t(t.end() - t.begin()) ? t.begin()[i] : *static_cast<E*>(f.state.get())))
+                            return wait;
+                    }
+                    else
+                    {
+                        auto& it = *std::launder(reinterpret_cast<I*>(f.it));
+                        auto& v = *it;
+
+                        ++it;
+                        ++f.i;
+
+                        if (!descend(d, v))
+                            return wait;
+                    }
+                }
+
+                return pop;
+            }
+            else
+            {
+                // an element is decoded into the entry, or into a recycled node under reuse, k is the phase
+                // to go on with once the part being decoded is complete
+
+                auto& c = *static_cast<scratch<U>*>(f.state.get());
+                auto& e = c.entry;
+
+                constexpr bool mapped = requires { typename U::mapped_type; };
+
+                for (;;)
+                {
+                     if (f.k == 1)
+                     {
+                         if (f.i == f.n)
+                             return pop;
+
+                         if constexpr(recyclable<U>)
+                         {
+                             if (!c.nodes.empty())
+                             {
+                                 c.node = c.nodes.extract(c.nodes.begin());
+                                 f.k = 4;
+
+                                 if constexpr(mapped)
+                                 {
+                                     if (!descend(d, c.node.key()))
+                                         return wait;
+                                 }
+                                 else if (!descend(d, c.node.value()))
+                                     return wait;
+
+                                 continue;
+                             }
+                         }
+
+                         f.k = 2;
+
+                         if constexpr(mapped)
+                         {
+                             if (!descend(d, e.first))
+                                 return wait;
+                         }
+                         else if (!descend(d, e))
+                             return wait;
+                     }
+                     else if (f.k == 2)
+                     {
+                         f.k = 3;
+
+                         if constexpr(mapped)
+                         {
+                             if (!descend(d, e.second))
+                                 return wait;
+                         }
+                     }
+                     else if (f.k == 3)
+                     {
+                         if constexpr(mapped)
+                             hint(t, std::move(e.first), std::move(e.second));
+                         else
+                             hint(t, std::move(e));
+
+                         e = entry_t<U>();
+
+                         f.k = 1;
+                         ++f.i;
+                     }
+                     else if (f.k == 4)
+                     {
+                         f.k = 5;
+
+                         if constexpr(mapped && recyclable<U>)
+                         {
+                             if (!descend(d, c.node.mapped()))
+                                 return wait;
+                         }
+                     }
+                     else
+                     {
+                         if constexpr(recyclable<U>)
+                         {
+                             if constexpr(requires { typename U::key_compare; })
+                                 t.insert(t.end(), std::move(c.node));
+                             else
+                                 t.insert(std::move(c.node));
+                         }
+
+                         f.k = 1;
+                         ++f.i;
+                     }
+                }
+            }
+        }
+
+        // the ranges copied as a whole, dense elements only when the byte order is native
+
+        template <typename U>
+        static constexpr bool bulk = is_string_v<U> || is_bulk_v<U> || requires (U t)
+        {
+            requires is_dense_v<std::remove_cvref_t<decltype(*t.data())>>;
+            requires ! requires { requires P::order != std::endian::native; };
+        };
+
+        // an element of an associative container is decoded into an entry, then moved in
+
+        template <typename U>
+        static auto entry()
+        {
+            if constexpr(requires { typename U::mapped_type; })
+                return std::type_identity<std::pair<typename U::key_type, typename U::mapped_type>>();
+            else
+                return std::type_identity<typename U::key_type>();
+        }
+
+        template <typename U>
+        using entry_t = typename decltype(entry<U>())::type;
+
+        template <typename U>
+        static constexpr bool recyclable = requires (U t) { requires P::recycle; t.extract(t.begin()); };
+
+        template <typename U>
+        static auto node()
+        {
+            if constexpr(recyclable<U>)
+                return std::type_identity<typename U::node_type>();
+            else
+                return std::type_identity<bool>();
+        }
+
+        template <typename U>
+        struct scratch
+        {
+            U nodes;
+            entry_t<U> entry;
+
+            typename decltype(node<U>())::type node;
+        };
+
+        template <typename U, typename... Args>
+        static void hint(U& t, Args&&... args)
+        {
+            if constexpr(requires { typename U::key_compare; })
+                t.emplace_hint(t.end(), std::forward<Args>(args)...);
+            else
+                t.emplace(std::forward<Args>(args)...);
+        }
+
+        void run(const char* s, size_t n)
+        {
+            data = s;
+            size = n;
+
+            l = 0;
+
+            while (!frames.empty())
+            {
+                 auto& f = frames.back();
+
+                 if (f.step(*this, f) == wait)
+                     break;
+
+                 frames.pop_back();
+            }
+        }
+
+        std::vector<frame> frames;
+        std::string in;
+
+        const char* data = nullptr;
+        size_t size = 0;
+        size_t l = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,197 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+#ifndef DIFF_HPP
+#define DIFF_HPP
+
+#include <string>
+#include <algorithm>
+#include <reflect.hpp>
+
+namespace fmp
+{
+    // whether two values are the same, leaves are compared with eq, pointees rather than addresses
+
+    template <typename T>
+    constexpr bool same(const T& t, const T& u)
+    {
+        using U = std::remove_cvref_t<T>;
+
+        if constexpr(std::is_pointer_v<U> || requires { typename U::weak_type; })
+            return t == u || (t && u && same(*t, *u));
+        else if constexpr(requires { t.has_value(); })
+            return t.has_value() == u.has_value() && (!t || same(*t, *u));
+        else if constexpr(requires { t.first; t.second; })
+            return same(t.first, u.first) && same(t.second, u.second);
+        else if constexpr(is_variant_v<U>)
+        {
+            return t.index() == u.index() && [&]<size_t... N>(std::index_sequence<N...>)
+            {
+                return t.valueless_by_exception() || ((t.index() == N && same(*std::get_if<N>(&t), *std::get_if<N>(&u))) || ...);
+            }
+            (std::make_index_sequence<std::variant_size_v<U>>());
+        }
+        else if constexpr(is_string_v<U>)
+            return eq(t, u);
+        else if constexpr(std::is_array_v<U> || requires { t.begin(); t.end(); })
+            return std::ranges::equal(t, u, [](auto& a, auto& b){ return same(a, b); });
+        else if constexpr(is_record_v<U>)
+        {
+            bool r = true;
+
+            zip([&](auto& a, auto& b)
+            {
+                r = r && same(a, b);
+            }, fields(t), fields(u));
+
+            return r;
+        }
+        else
+            return eq(t, u);
+    }
+
+    // append the patch turning t into u to s, a patch of a record is a bitmask of its changed members
+    // followed by the patches of the changed records and the marshaled values of the other changed
+    // members, a record member without changes costs nothing but its bit
+
+    template <typename S, typename T, typename P>
+    requires is_policy_v<P>
+    constexpr decltype(auto) diff(S&& s, const T& t, const T& u, P&& p)
+    {
+        size_t k = s.size();
+        s.append((fields_v<T> + 7) / 8, '\0');
+
+        size_t i = 0;
+        bool changed = false;
+
+        zip([&]<typename V>(const V& a, const V& b)
+        {
+            size_t m = s.size();
+
+            if constexpr(is_record_v<V>)
+            {
+                if (!diff(s, a, b, p))
+                    s.resize(m);
+            }
+            else if (!same(a, b))
+            {
+                size_t l = m;
+                assigner<1, std::remove_reference_t<P>>{p}.template replicate<1>(l, s, b);
+            }
+
+            if (s.size() != m)
+            {
+                s[k + i / 8] |= 1 << i % 8;
+                changed = true;
+            }
+
+            ++i;
+        }, fields(t), fields(u));
+
+        return changed;
+    }
+
+    template <typename S, typename T>
+    requires (!is_policy_v<T>)
+    constexpr decltype(auto) diff(S&& s, const T& t, const T& u)
+    {
+        return diff(std::forward<S>(s), t, u, policy());
+    }
+
+    template <typename T, typename P>
+    requires is_policy_v<P>
+    constexpr decltype(auto) diff(const T& t, const T& u, P&& p)
+    {
+        std::string s;
+        diff(s, t, u, std::forward<P>(p));
+
+        return s;
+    }
+
+    template <typename T>
+    constexpr decltype(auto) diff(const T& t, const T& u)
+    {
+        return diff(t, u, policy());
+    }
+
+    // append a patch setting every member of t to s
+
+    template <typename S, typename T, typename P>
+    requires is_policy_v<P>
+    constexpr decltype(auto) overwrite(S&& s, const T& t, P&& p)
+    {
+        constexpr size_t n = fields_v<T>;
+        s.append(n / 8, '\xff');
+
+        if constexpr(n % 8 != 0)
+            s += char((1 << n % 8) - 1);
+
+        fmp::for_each([&]<typename V>(const V& v)
+        {
+            if constexpr(is_record_v<V>)
+                overwrite(s, v, p);
+            else
+            {
+                size_t l = s.size();
+                assigner<1, std::remove_reference_t<P>>{p}.template replicate<1>(l, s, v);
+            }
+        }, fields(t));
+
+        return std::forward<S>(s);
+    }
+
+    // apply a patch made by diff to t in place, the members without a bit are left as they are
+
+    template <typename S, typename T, typename P>
+    requires is_policy_v<P>
+    constexpr decltype(auto) apply_patch(size_t& l, S&& s, T&& t, P&& p)
+    {
+        size_t k = l;
+        l += (fields_v<std::remove_cvref_t<T>> + 7) / 8;
+
+        fmp::for_each([&, i = size_t(0)]<typename V>(V& v) mutable
+        {
+            if (s[k + i / 8] >> i % 8 & 1)
+            {
+                if constexpr(is_record_v<std::remove_cvref_t<V>>)
+                    apply_patch(l, s, v, p);
+                else
+                {
+                    // containers are replaced rather than merged into
+
+                    if constexpr(requires { v.clear(); })
+                        v.clear();
+
+                    assigner<1, std::remove_reference_t<P>>{p}.template replicate<0>(l, s, v);
+                }
+            }
+
+            ++i;
+        }, fields(t));
+
+        return std::forward<T>(t);
+    }
+
+    template <typename T, typename S, typename P>
+    requires is_policy_v<P>
+    constexpr decltype(auto) apply_patch(T&& t, S&& s, P&& p)
+    {
+        size_t l = 0;
+
+        return apply_patch(l, std::forward<S>(s), std::forward<T>(t), std::forward<P>(p));
+    }
+
+    template <typename T, typename S>
+    constexpr decltype(auto) apply_patch(T&& t, S&& s)
+    {
+        return apply_patch(std::forward<T>(t), std::forward<S>(s), policy());
+    }
+}
+
+#endif
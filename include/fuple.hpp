@@ -10,6 +10,7 @@
 #ifndef FUPLE_HPP
 #define FUPLE_HPP
 
+#include <array>
 #include <utility>
 #include <algorithm>
 #include <functional>
@@ -23,9 +24,6 @@ namespace fmp
     template <typename T, typename... Args>
     using outer_t = typename std::conditional_t<!sizeof...(Args), T, std::type_identity<T>>::type;
 
-    template <typename T>
-    using inner_t = outer_t<urd_t<outer_t<T>>>;
-
     struct ignore_t
     {
         template <typename T>
@@ -36,12 +34,14 @@ namespace fmp
 
     inline constexpr ignore_t ignore;
 
+    // an empty element takes no storage, it shares its address with the elements after it
+
     template <size_t N, typename T>
     struct element
     {
         using type = T;
 
-        T value;
+        [[no_unique_address]] T value;
     };
 
     template <size_t N, typename T>
@@ -75,6 +75,9 @@ namespace fmp
         constexpr elements(elements&&) = default;
         constexpr elements(const elements&) = default;
 
+        constexpr elements& operator=(elements&&) = default;
+        constexpr elements& operator=(const elements&) = default;
+
         static constexpr size_t value = 0;
 
         static constexpr size_t size() noexcept
@@ -93,6 +96,9 @@ namespace fmp
         constexpr elements(elements&&) = default;
         constexpr elements(const elements&) = default;
 
+        constexpr elements& operator=(elements&&) = default;
+        constexpr elements& operator=(const elements&) = default;
+
         constexpr elements(Args&&... args) : element<N, Args>(std::forward<Args>(args))...
         {
         }
@@ -153,6 +159,12 @@ namespace fmp
             (std::make_index_sequence<l < r ? l : r>());
         }
 
+        // the assignments are the implicit ones when the elements allow them, so a fuple of trivially
+        // copyable elements is trivially copyable, the others, holding references, assign through them
+
+        constexpr fuple& operator=(fuple&&) requires std::is_move_assignable_v<elements<std::index_sequence_for<Args...>, Args...>> = default;
+        constexpr fuple& operator=(const fuple&) requires std::is_copy_assignable_v<elements<std::index_sequence_for<Args...>, Args...>> = default;
+
         constexpr fuple& operator=(fuple<Args...>&& r)
         {
             return assign(std::move(r));
@@ -192,10 +204,19 @@ namespace fmp
     template <typename T>
     inline constexpr auto is_fuple_v = is_fuple<T>::value;
 
-    template <template <typename ...> typename F, typename T, typename U = T, typename... Args>
+    // the index of the first of Args that F matches with T, the size of Args if there is none
+
+    template <template <typename ...> typename F, typename T, typename... Args>
     constexpr size_t index()
     {
-        return F<T, U>() ? 0 : index<F, T, Args...>() + 1;
+        constexpr bool matches[] { F<T, Args>::value..., true };
+
+        size_t i = 0;
+
+        while (!matches[i])
+            ++i;
+
+        return i;
     }
 
     template <bool strip, typename... Args>
@@ -287,6 +308,175 @@ namespace fmp
     template <size_t N, typename T>
     using fuple_element_t = outer_t<fuple_element<N, T>>;
 
+    // the order a packed_fuple stores Args in, by decreasing alignment and then as declared, every
+    // element ends at a multiple of the alignment of the next one, so the only padding is at the end
+
+    template <typename... Args>
+    inline constexpr auto packed_order = []
+    {
+        constexpr size_t aligns[] { alignof(element<0, Args>)..., 0 };
+        std::array<size_t, sizeof...(Args)> order {};
+
+        for (size_t i = 0; i != order.size(); ++i)
+        {
+             size_t j = i;
+
+             for (; j && aligns[order[j - 1]] < aligns[i]; --j)
+                  order[j] = order[j - 1];
+
+             order[j] = i;
+        }
+
+        return order;
+    }();
+
+    template <typename T, typename... Args>
+    struct packed;
+
+    template <size_t... N, typename... Args>
+    struct packed<std::index_sequence<N...>, Args...>
+    {
+        using type = elements<std::index_sequence<packed_order<Args...>[N]...>, std::tuple_element_t<packed_order<Args...>[N], std::tuple<Args...>>...>;
+    };
+
+    template <typename... Args>
+    using packed_t = typename packed<std::index_sequence_for<Args...>, Args...>::type;
+
+    // a fuple laid out without inner padding, element<N, T> is still the base holding the N-th element,
+    // only the bases come in the order of packed_order, so get, fuple_element, for_each, apply and the
+    // comparisons see the elements in the order they are declared
+
+    template <typename... Args>
+    struct packed_fuple : packed_t<Args...>
+    {
+        using type = typename fuple<Args...>::type;
+
+        constexpr packed_fuple() = default;
+
+        constexpr packed_fuple(packed_fuple&&) = default;
+        constexpr packed_fuple(const packed_fuple&) = default;
+
+        constexpr packed_fuple& operator=(packed_fuple&&) requires std::is_move_assignable_v<packed_t<Args...>> = default;
+        constexpr packed_fuple& operator=(const packed_fuple&) requires std::is_copy_assignable_v<packed_t<Args...>> = default;
+
+        constexpr packed_fuple& operator=(packed_fuple&& r)
+        {
+            return assign(std::move(r));
+        }
+
+        constexpr packed_fuple& operator=(const packed_fuple& r)
+        {
+            return assign(r);
+        }
+
+        template <typename T>
+        constexpr packed_fuple& assign(T&& t)
+        {
+            [&]<size_t... N>(std::index_sequence<N...>)
+            {
+                (..., (select<N>(*this) = select<N>(std::forward<T>(t))));
+            }
+            (std::index_sequence_for<Args...>());
+
+            return *this;
+        }
+
+        constexpr packed_fuple(Args&&... args) requires (sizeof...(Args) != 0) :
+        packed_fuple(std::index_sequence_for<Args...>(), fuple<Args&&...>(std::forward<Args>(args)...))
+        {
+        }
+
+        template <typename T>
+        requires (std::is_same_v<std::remove_cvref_t<T>, fuple<Args...>> || std::is_same_v<std::remove_cvref_t<T>, std::tuple<Args...>>)
+        constexpr packed_fuple(T&& t) : packed_fuple(std::index_sequence_for<Args...>(), std::forward<T>(t))
+        {
+        }
+
+        template <size_t... N, typename T>
+        constexpr packed_fuple(std::index_sequence<N...>, T&& t) :
+        packed_t<Args...>(static_cast<std::tuple_element_t<packed_order<Args...>[N], std::tuple<Args...>>>(pick<packed_order<Args...>[N]>(std::forward<T>(t)))...)
+        {
+        }
+
+        template <size_t N, typename T>
+        static constexpr decltype(auto) pick(T&& t)
+        {
+            if constexpr(is_tuple_v<std::remove_cvref_t<T>>)
+                return std::get<N>(std::forward<T>(t));
+            else
+                return select<N>(std::forward<T>(t));
+        }
+
+        template <typename T>
+        requires (std::is_same_v<T, fuple<Args...>> || std::is_same_v<T, std::tuple<Args...>>)
+        constexpr operator T() const
+        {
+            return [&]<size_t... N>(std::index_sequence<N...>)
+            {
+                return T(static_cast<Args>(select<N>(*this))...);
+            }
+            (std::index_sequence_for<Args...>());
+        }
+    };
+
+    template <typename... Args>
+    packed_fuple(Args...) -> packed_fuple<Args...>;
+
+    template <typename... Args>
+    struct is_fuple<packed_fuple<Args...>> : std::true_type
+    {
+    };
+
+    template <size_t N, typename... Args>
+    requires (N < sizeof...(Args))
+    constexpr decltype(auto) get(packed_fuple<Args...>& t) noexcept
+    {
+        return select<N>(t);
+    }
+
+    template <size_t N, typename... Args>
+    requires (N < sizeof...(Args))
+    constexpr decltype(auto) get(packed_fuple<Args...>&& t) noexcept
+    {
+        return select<N>(std::move(t));
+    }
+
+    template <size_t N, typename... Args>
+    requires (N < sizeof...(Args))
+    constexpr decltype(auto) get(const packed_fuple<Args...>& t) noexcept
+    {
+        return select<N>(t);
+    }
+
+    template <typename T, typename... Args>
+    constexpr decltype(auto) get(packed_fuple<Args...>& t) noexcept
+    {
+        return select<index<1, T, Args...>()>(t);
+    }
+
+    template <typename T, typename... Args>
+    constexpr decltype(auto) get(packed_fuple<Args...>&& t) noexcept
+    {
+        return select<index<1, T, Args...>()>(std::move(t));
+    }
+
+    template <typename T, typename... Args>
+    constexpr decltype(auto) get(const packed_fuple<Args...>& t) noexcept
+    {
+        return select<index<1, T, Args...>()>(t);
+    }
+
+    template <typename... Args>
+    struct fuple_size<packed_fuple<Args...>> : std::integral_constant<size_t, sizeof...(Args)>
+    {
+    };
+
+    template <size_t N, typename... Args>
+    struct fuple_element<N, packed_fuple<Args...>>
+    {
+        using type = std::remove_cvref_t<decltype(get<N>(std::declval<packed_fuple<Args...>>()))>;
+    };
+
     template <typename... Args>
     constexpr decltype(auto) tie(Args&... args)
     {
@@ -305,28 +495,18 @@ namespace fmp
         return fuple<Args&&...>(std::forward<Args>(args)...);
     }
 
-    template <typename T, template <typename ...> typename U, typename... Args>
-    constexpr decltype(auto) outer(U<Args...>)
-    {
-        return U<outer_t<T, Args>...>();
-    }
-
-    template <template <typename ...> typename T, typename... Args>
-    constexpr decltype(auto) outer(T<Args...>)
-    {
-        return (... + outer<Args>(inner_t<Args>()));
-    }
+    // the N-th element forwarded as the type it is declared with
 
-    template <template <typename ...> typename T, typename... Args>
-    constexpr decltype(auto) inner(T<Args...>)
+    template <size_t N, typename T>
+    constexpr T&& forward_element(element<N, T>& m) noexcept
     {
-        return (... + inner_t<Args>());
+        return std::forward<T>(m.value);
     }
 
-    template <typename T, typename U>
-    constexpr decltype(auto) over(U&& u)
+    template <size_t N, typename T>
+    constexpr const T& forward_element(const element<N, T>& m) noexcept
     {
-        return std::forward<outer_t<T>>(std::forward<U>(u).T::value);
+        return m.value;
     }
 
     template <typename... Args>
@@ -337,14 +517,15 @@ namespace fmp
             return fuple();
         else
         {
-            decltype(auto) f = outer_t<fuple<Args&&...>>();
             decltype(auto) t = forward_as_fuple(std::forward<Args>(args)...);
 
-            return [&]<template <typename ...> typename T, typename... O, typename... I>(T<O...>, T<I...>)
+            using C = concat<length_v<Args>...>;
+
+            return [&]<size_t... K>(std::index_sequence<K...>)
             {
-                return forward_as_fuple(over<I>(over<O>(t))...);
+                return forward_as_fuple(forward_element<C::indices[K][1]>(get<C::indices[K][0]>(t))...);
             }
-            (outer(f), inner(f));
+            (std::make_index_sequence<C::size>());
         }
     }
 
@@ -352,10 +533,16 @@ namespace fmp
     requires (is_fuple_v<std::remove_cvref_t<Args>> && ...)
     void zip(F&& f, Args&&... args)
     {
-        std::invoke(std::forward<F>(f), get<lower>(std::forward<Args>(args))...);
+        auto call = [&]<size_t N>(std::integral_constant<size_t, N>)
+        {
+            std::invoke(std::forward<F>(f), get<N>(std::forward<Args>(args))...);
+        };
 
-        if constexpr(lower + 1 != upper)
-            zip<lower + 1, upper>(std::forward<F>(f), std::forward<Args>(args)...);
+        [&]<size_t... N>(std::index_sequence<N...>)
+        {
+            (..., call(std::integral_constant<size_t, lower + N>()));
+        }
+        (std::make_index_sequence<upper - lower>());
     }
 
     template <typename F, typename... Args>
@@ -398,15 +585,24 @@ namespace fmp
     requires (is_fuple_v<std::remove_cvref_t<T>> && is_fuple_v<std::remove_cvref_t<U>>)
     constexpr decltype(auto) apply(F&& f, T&& t, U&& u)
     {
-        if constexpr(i == j)
-            return std::invoke(std::forward<F>(f), std::remove_cvref_t<T>::size(), std::remove_cvref_t<U>::size());
-        else
+        // the first pair of elements f holds for decides, unless a pair before it differs
+
+        bool r = false;
+
+        auto equal = [&](auto&& a, auto&& b)
         {
-            decltype(auto) l = get<i>(std::forward<T>(t));
-            decltype(auto) r = get<i>(std::forward<U>(u));
+            r = std::invoke(f, a, b);
+
+            return !r && a == b;
+        };
 
-            return std::invoke(std::forward<F>(f), l, r) || (l == r && apply<i + 1, j>(std::forward<F>(f), std::forward<T>(t), std::forward<U>(u)));
+        bool e = [&]<size_t... N>(std::index_sequence<N...>)
+        {
+            return (... && equal(get<i + N>(std::forward<T>(t)), get<i + N>(std::forward<U>(u))));
         }
+        (std::make_index_sequence<j - i>());
+
+        return e ? std::invoke(std::forward<F>(f), std::remove_cvref_t<T>::size(), std::remove_cvref_t<U>::size()) : r;
     }
 
     template <typename F, typename T, typename U>
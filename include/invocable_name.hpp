@@ -69,6 +69,20 @@ namespace fmp
     template <auto f>
     inline constexpr auto invocable_stem_v = invocable_stem<f>();
 
+    template <typename T>
+    consteval decltype(auto) type_name() noexcept
+    {
+         constexpr std::string_view n{__PRETTY_FUNCTION__};
+         constexpr std::string_view k{"[with T = "};
+
+         constexpr auto p = n.find(k) + k.size();
+
+         return n.substr(p, n.size() - p - 1);
+    }
+
+    template <typename T>
+    inline constexpr auto type_name_v = type_name<T>();
+
     template <auto e>
     requires std::is_enum_v<decltype(e)>
     consteval decltype(auto) in_range()
@@ -0,0 +1,157 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+#ifndef LAYOUT_HPP
+#define LAYOUT_HPP
+
+#include <array>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+#include <reflect.hpp>
+
+namespace fmp
+{
+    // the placement of a member, padding is the gap between its end and the next member or the end of
+    // the record
+
+    struct member_layout
+    {
+        std::string_view name;
+
+        size_t offset;
+        size_t size;
+        size_t align;
+        size_t padding;
+
+        bool trivial;
+    };
+
+    // the layout of a record, order is the members by decreasing alignment, placed so they need no
+    // padding but the one rounding the size up to the alignment, packed is the size they take then,
+    // the members of a base are counted as if they could be moved too, a layout is inexact when the
+    // offsets computed from the member types don't add up to the record, as with alignas or
+    // [[no_unique_address]] members, it has no padding nor reordering then
+
+    template <typename T>
+    struct layout
+    {
+        static constexpr size_t count = arity_v<T>;
+
+        std::string_view name;
+
+        std::array<member_layout, count> members;
+        std::array<size_t, count> order;
+
+        size_t size;
+        size_t align;
+        size_t padding;
+        size_t packed;
+
+        bool exact;
+
+        // the bytes saved by reordering the members
+
+        constexpr size_t waste() const noexcept
+        {
+            return size - packed;
+        }
+
+        // the members with their padding, and the reordering when it saves any
+
+        std::ostream& report(std::ostream& os) const
+        {
+            os << name << ": size " << size << ", align " << align << ", padding " << padding << (exact ? "" : ", inexact") << '\n';
+            os << std::setw(10) << "offset" << std::setw(8) << "size" << std::setw(8) << "align" << std::setw(10) << "padding" << std::setw(10) << "trivial" << "  member\n";
+
+            for (auto& m : members)
+            {
+                 os << std::setw(10) << m.offset << std::setw(8) << m.size << std::setw(8) << m.align << std::setw(10) << m.padding;
+                 os << std::setw(10) << (m.trivial ? "yes" : "no") << "  " << m.name << '\n';
+            }
+
+            if (waste())
+            {
+                os << "reordered to";
+
+                for (auto i : order)
+                     os << ' ' << members[i].name;
+
+                os << ": size " << packed << ", padding " << padding - waste() << ", " << waste() << " bytes saved\n";
+            }
+
+            return os;
+        }
+    };
+
+    template <typename T>
+    consteval decltype(auto) make_layout()
+    {
+        layout<T> l {};
+
+        l.name = type_name_v<T>;
+
+        l.size = sizeof(T);
+        l.align = alignof(T);
+
+        [&]<typename... Args, size_t... N>(std::type_identity<fuple<Args...>>, std::index_sequence<N...>)
+        {
+            ((l.members[N] = { member_name_v<N, T>, size_t(offset_of<N, T>()), sizeof(Args), alignof(Args), 0, std::is_trivially_copyable_v<Args> }), ...);
+        }
+        (std::type_identity<members_t<T>>(), std::make_index_sequence<layout<T>::count>());
+
+        for (size_t i = 0; i != l.count; ++i)
+             l.order[i] = i;
+
+        size_t align = 1;
+        size_t end = 0;
+
+        for (auto& m : l.members)
+        {
+             align = std::max(align, m.align);
+             end = std::max(end, m.offset + m.size);
+        }
+
+        l.exact = align == l.align && std::max<size_t>((end + align - 1) / align * align, 1) == l.size;
+
+        if (!l.exact)
+        {
+            l.packed = l.size;
+
+            return l;
+        }
+
+        l.padding = l.size;
+
+        for (size_t i = l.count, end = l.size; i-- != 0; end = l.members[i].offset)
+        {
+             l.members[i].padding = end - l.members[i].offset - l.members[i].size;
+             l.padding -= l.members[i].size;
+        }
+
+        std::sort(l.order.begin(), l.order.end(), [&](size_t i, size_t j)
+        {
+            return l.members[i].align > l.members[j].align || (l.members[i].align == l.members[j].align && i < j);
+        });
+
+        for (auto i : l.order)
+             l.packed += l.members[i].size;
+
+        // an object takes a byte at least, a record without members too
+
+        l.packed = std::min(std::max<size_t>((l.packed + l.align - 1) / l.align * l.align, 1), l.size);
+
+        return l;
+    }
+
+    template <typename T>
+    inline constexpr auto layout_v = make_layout<T>();
+}
+
+#endif
@@ -10,6 +10,7 @@
 #ifndef LISTS_HPP
 #define LISTS_HPP
 
+#include <array>
 #include <tuple>
 #include <cstddef>
 #include <utility>
@@ -99,37 +100,43 @@ namespace fmp
     template <typename T>
     using rank = std::make_index_sequence<pack_size_v<std::decay_t<T>>>;
 
-    template <auto m, template <typename, auto ...> typename T, typename U, auto... n>
-    constexpr decltype(auto) over(T<U, n...>)
-    {
-        return type_pack<auto_pack<m, n>...>();
-    }
+    // the argument and the position within it of every element of a concatenation of packs of N...
+    // elements, filled in a single pass, so a concatenation expands one index sequence of its size
 
-    template <typename... Args>
-    constexpr decltype(auto) rank_pack(Args&&... args)
+    template <size_t... N>
+    struct concat
     {
-        return []<auto... N>(std::index_sequence<N...>)
+        static constexpr size_t size = (N + ... + 0);
+
+        static constexpr auto indices = []
         {
-            return (... + over<N>(rank<Args>()));
-        }
-        (std::index_sequence_for<Args...>());
-    }
+            constexpr size_t sizes[] { N..., 0 };
+            std::array<std::array<size_t, 2>, size> r {};
+
+            for (size_t k = 0, m = 0, n = 0; k != size; ++k, ++n)
+            {
+                 for (; n == sizes[m]; n = 0)
+                      ++m;
+
+                 r[k] = { m, n };
+            }
+
+            return r;
+        }();
+    };
 
     template <typename... Args>
     constexpr decltype(auto) tuple_cat(Args&&... args)
     {
         auto t = std::forward_as_tuple(std::forward<Args>(args)...);
 
-        if constexpr(!sizeof...(Args))
-            return t;
-        else
+        using C = concat<pack_size_v<std::decay_t<Args>>...>;
+
+        return [&]<size_t... K>(std::index_sequence<K...>)
         {
-            return [&]<template <typename ...> typename T, template <auto ...> typename U, auto... m, auto... n>(T<U<m, n>...>)
-            {
-                return std::forward_as_tuple(std::get<n>(std::get<m>(t))...);
-            }
-            (rank_pack(std::forward<Args>(args)...));
+            return std::forward_as_tuple(std::get<C::indices[K][1]>(std::get<C::indices[K][0]>(t))...);
         }
+        (std::make_index_sequence<C::size>());
     }
 
     template <typename T>
@@ -0,0 +1,136 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+#ifndef POLICY_HPP
+#define POLICY_HPP
+
+#include <bit>
+#include <memory>
+#include <memory_resource>
+#include <crc32c.hpp>
+
+namespace fmp
+{
+    // the base of the policies that customize marshaling and unmarshaling, a policy
+    // exposes hooks which are detected by the assigner, the plain policy exposes none
+
+    struct policy
+    {
+    };
+
+    template <typename T>
+    inline constexpr auto is_policy_v = std::is_base_of_v<policy, std::remove_cvref_t<T>>;
+
+    // combine several policies into one
+
+    template <typename... Args>
+    struct policies : Args...
+    {
+    };
+
+    // marshal every member as a tagged entry instead of by position, so that members can be added,
+    // removed and reordered, the decoder skips the unknown entries and leaves the absent members as
+    // they are, the tags come from member_tags_v
+
+    struct tagged : policy
+    {
+        static constexpr bool tagging = true;
+    };
+
+    // the byte order of the fundamentals, the size prefixes and the tags on the wire, buffers written in
+    // an explicit order are portable between hosts, the native order costs nothing
+
+    template <std::endian E>
+    struct byte_order : policy
+    {
+        static constexpr std::endian order = E;
+    };
+
+    using little_endian = byte_order<std::endian::little>;
+    using big_endian = byte_order<std::endian::big>;
+    using native_endian = byte_order<std::endian::native>;
+
+    // prefix the message with the schema_hash_v of its type, unmarshaling a message written from another
+    // definition of the type is rejected with one integer compare and leaves the object untouched
+
+    struct fingerprint : policy
+    {
+        bool rejected = false;
+    };
+
+    // frame the message as [length][crc32c][payload], the checksum is folded in as the bytes are written
+    // while they are still in cache, a truncated or corrupted frame is detected before anything of the
+    // message is decoded or allocated, the object is left untouched and the frame is skipped
+
+    struct framed : policy
+    {
+        uint32_t crc = 0;
+        bool corrupted = false;
+
+        void digest(const void* data, size_t size)
+        {
+            crc = crc32c(data, size, crc);
+        }
+    };
+
+    // unmarshal into an existing object without giving up its storage, associative containers recycle
+    // their nodes (keys and values keep their capacity), vectors and strings keep their capacity, the
+    // targets of pointers and std::shared_ptr (when not shared) are reused, steady state decoding of
+    // a message of the same shape allocates nothing but the bucket array of unordered containers
+
+    struct reuse : policy
+    {
+        static constexpr bool recycle = true;
+    };
+
+    // unmarshal into a memory resource, allocator aware containers are rebound to the resource,
+    // pointers and std::shared_ptr are placed in it, the pointees are never deleted but released
+    // along with the resource, e.g. a std::pmr::monotonic_buffer_resource frees a message in O(1)
+
+    struct arena : policy
+    {
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource();
+
+        template <typename T>
+        constexpr decltype(auto) rebind(T& t)
+        {
+            if constexpr(requires { t.get_allocator().resource(); })
+            {
+                if (t.get_allocator().resource() != resource)
+                {
+                    std::destroy_at(std::addressof(t));
+                    std::construct_at(std::addressof(t), typename T::allocator_type(resource));
+                }
+            }
+        }
+
+        template <typename V, typename T>
+        constexpr decltype(auto) make(T& t)
+        {
+            if constexpr(std::uses_allocator_v<V, typename T::allocator_type>)
+                return std::make_obj_using_allocator<V>(t.get_allocator());
+            else
+                return V();
+        }
+
+        template <typename T>
+        constexpr decltype(auto) create()
+        {
+            return std::pmr::polymorphic_allocator<>(resource).new_object<T>();
+        }
+
+        template <typename T>
+        constexpr decltype(auto) share()
+        {
+            return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(resource));
+        }
+    };
+}
+
+#endif
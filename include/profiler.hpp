@@ -0,0 +1,170 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <unordered_map>
+#include <reflect.hpp>
+
+namespace fmp
+{
+    // an instrumented policy of the assigner, it accounts the bytes, the heap allocations made on
+    // unmarshaling (resize, emplace, new and make_shared) and the time spent per member path,
+    // the figures of a path are inclusive of its nested members
+
+    struct profiler : policy
+    {
+        using clock = std::chrono::steady_clock;
+
+        struct record
+        {
+            std::string path;
+            size_t calls;
+            size_t bytes;
+            size_t allocations;
+            std::chrono::nanoseconds elapsed;
+        };
+
+        struct frame
+        {
+            size_t row;
+            size_t offset;
+            size_t length;
+            size_t allocations;
+            clock::time_point start;
+        };
+
+        template <typename T>
+        static std::string label(size_t i)
+        {
+            if constexpr(is_fuple_v<T> || is_tuple_v<T> || requires (T t) { t.first; t.second; })
+                return std::to_string(i);
+            else
+            {
+                return apply([&]<typename... Args>(Args&&... args)
+                {
+                    std::string_view names[] = { args... };
+
+                    return std::string(names[i]);
+                }, member_names_v<T>);
+            }
+        }
+
+        template <typename T>
+        void enter(size_t l, size_t i)
+        {
+            size_t length = path.length();
+
+            if (length)
+                path += '.';
+
+            path += label<T>(i);
+
+            auto [it, inserted] = rows.try_emplace(path, table.size());
+
+            if (inserted)
+                table.push_back({ path, 0, 0, 0, {} });
+
+            frames.push_back({ it->second, l, length, allocations, clock::now() });
+        }
+
+        void leave(size_t l)
+        {
+            frame f = frames.back();
+            record& r = table[f.row];
+
+            ++r.calls;
+
+            r.bytes += l - f.offset;
+            r.allocations += allocations - f.allocations;
+
+            r.elapsed += clock::now() - f.start;
+
+            frames.pop_back();
+            path.resize(f.length);
+        }
+
+        void allocate(size_t n)
+        {
+            allocations += n;
+        }
+
+        void clear()
+        {
+            table.clear();
+            rows.clear();
+
+            frames.clear();
+            path.clear();
+
+            allocations = 0;
+        }
+
+        // invoke f with the fields of every record in first seen order
+
+        template <typename F>
+        decltype(auto) visit(F&& f) const
+        {
+            for (auto& r : table)
+                 fmp::apply(f, r);
+
+            return std::forward<F>(f);
+        }
+
+        decltype(auto) begin() const noexcept
+        {
+            return table.begin();
+        }
+
+        decltype(auto) end() const noexcept
+        {
+            return table.end();
+        }
+
+        decltype(auto) size() const noexcept
+        {
+            return table.size();
+        }
+
+        template <typename S>
+        S& report(S& s) const
+        {
+            size_t width = 4;
+
+            for (auto& r : table)
+                 width = std::max(width, r.path.length());
+
+            s << std::left << std::setw(width) << "path" << std::right << std::setw(12) << "calls"
+              << std::setw(14) << "bytes" << std::setw(14) << "allocations" << std::setw(16) << "ns" << '\n';
+
+            visit([&](auto& path, auto calls, auto bytes, auto allocations, auto elapsed)
+            {
+                s << std::left << std::setw(width) << path << std::right << std::setw(12) << calls
+                  << std::setw(14) << bytes << std::setw(14) << allocations << std::setw(16) << elapsed.count() << '\n';
+            });
+
+            return s;
+        }
+
+        std::vector<record> table;
+        std::vector<frame> frames;
+
+        std::unordered_map<std::string, size_t> rows;
+
+        std::string path;
+        size_t allocations = 0;
+    };
+}
+
+#endif
@@ -10,14 +10,263 @@
 #ifndef REFLECT_HPP
 #define REFLECT_HPP
 
+#include <bit>
+#include <array>
 #include <memory>
+#include <cstddef>
 #include <cstring>
 #include <iomanip>
+#include <variant>
+#include <optional>
+#include <algorithm>
 #include <string_view>
+#include <policy.hpp>
 #include <visitor.hpp>
+#include <invocable_name.hpp>
 
 namespace fmp
 {
+    // a record whose base has members declares it through base_of, its own members are recorded by
+    // stateful friend injection, which CWG 2118 deems ill-formed, it works with gcc and clang
+
+    template <typename T>
+    struct base_of
+    {
+        using type = void;
+    };
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnon-template-friend"
+#endif
+
+    template <typename T, size_t I>
+    struct slot
+    {
+        friend constexpr auto slot_type(slot);
+    };
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+    template <typename T, size_t I, typename U>
+    struct capture
+    {
+    };
+
+    template <typename T, size_t I, typename U>
+    requires (!std::is_array_v<U>)
+    struct capture<T, I, U>
+    {
+        friend constexpr auto slot_type(slot<T, I>)
+        {
+            return std::type_identity<U>();
+        }
+    };
+
+    struct any
+    {
+        template <typename U>
+        operator U&() const noexcept;
+    };
+
+    template <typename T, size_t I>
+    struct probe
+    {
+        template <typename U, size_t = sizeof(capture<T, I, U>)>
+        operator U&() const noexcept;
+    };
+
+    struct stranger
+    {
+    };
+
+    template <typename U, size_t>
+    struct exact
+    {
+        operator U&() const noexcept;
+    };
+
+    template <size_t>
+    using any_t = any;
+
+    template <typename T, size_t N, typename = std::make_index_sequence<N>>
+    inline constexpr bool fits_v = false;
+
+    template <typename T, size_t N, size_t... I>
+    inline constexpr bool fits_v<T, N, std::index_sequence<I...>> = requires { T{ any_t<I>()... }; };
+
+    template <typename T, size_t I, typename U, typename = std::make_index_sequence<I>>
+    inline constexpr bool takes_v = false;
+
+    template <typename T, size_t I, typename U, size_t... N>
+    inline constexpr bool takes_v<T, I, U, std::index_sequence<N...>> = requires { T{ any_t<N>()..., std::declval<U>() }; };
+
+    template <typename T, typename E, size_t I, size_t K, typename = std::make_index_sequence<I>, typename = std::make_index_sequence<K>>
+    inline constexpr bool spans_v = false;
+
+    template <typename T, typename E, size_t I, size_t K, size_t... N, size_t... M>
+    inline constexpr bool spans_v<T, E, I, K, std::index_sequence<N...>, std::index_sequence<M...>> = requires { T{ any_t<N>()..., { exact<E, M>()... } }; };
+
+    template <typename T, size_t lower = 0, size_t upper = sizeof(T)>
+    consteval size_t initializers()
+    {
+        if constexpr(lower == upper)
+            return lower;
+        else
+        {
+            constexpr size_t middle = (lower + upper + 1) / 2;
+
+            if constexpr(fits_v<T, middle>)
+                return initializers<T, middle, upper>();
+            else
+                return initializers<T, lower, middle - 1>();
+        }
+    }
+
+    template <typename T, typename E, size_t I, size_t lower, size_t upper>
+    consteval size_t extent()
+    {
+        if constexpr(lower == upper)
+            return lower;
+        else
+        {
+            constexpr size_t middle = (lower + upper + 1) / 2;
+
+            if constexpr(spans_v<T, E, I, middle>)
+                return extent<T, E, I, middle, upper>();
+            else
+                return extent<T, E, I, lower, middle - 1>();
+        }
+    }
+
+    template <typename T, size_t I, typename = std::make_index_sequence<I>>
+    struct initializer;
+
+    template <typename T, size_t I, size_t... N>
+    struct initializer<T, I, std::index_sequence<N...>> : std::integral_constant<size_t, sizeof(T{ any_t<N>()..., probe<T, I>() })>
+    {
+        using type = typename decltype(slot_type(slot<T, I>()))::type;
+    };
+
+    template <typename T, size_t I>
+    using initializer_t = typename initializer<T, I>::type;
+
+    template <typename T>
+    using base_t = typename base_of<T>::type;
+
+    template <typename T>
+    inline constexpr auto has_base_v = !std::is_void_v<base_t<T>>;
+
+    // a multidimensional array comes out flattened
+
+    template <typename T, size_t I = 1, size_t N = initializers<T>(), typename... Args>
+    consteval auto own()
+    {
+        static_assert(std::is_base_of_v<base_t<T>, T> && !std::is_same_v<base_t<T>, T>, "the base_of a record is one of its bases");
+
+        constexpr bool opaque = I != N && (takes_v<T, I, stranger> || takes_v<T, I, std::nullopt_t>);
+
+        if constexpr(I == N || opaque)
+        {
+            static_assert(!opaque, "a member of a record with a base can't be a std::optional or convert from anything");
+
+            return std::type_identity<fuple<Args...>>();
+        }
+        else
+        {
+            using E = initializer_t<T, I>;
+
+            static_assert(!std::is_class_v<E> || !std::is_base_of_v<E, T>, "a record takes a single base class");
+
+            if constexpr(!spans_v<T, E, I, 2>)
+                return own<T, I + 1, N, Args..., E>();
+            else
+            {
+                constexpr size_t K = extent<T, E, I, 2, N - I>();
+
+                return own<T, I + K, N, Args..., E[K]>();
+            }
+        }
+    }
+
+    template <typename T>
+    using own_t = typename decltype(own<T>())::type;
+
+    template <typename T, typename M>
+    struct tail : T
+    {
+        M m;
+    };
+
+    template <typename T>
+    consteval decltype(auto) own_offsets()
+    {
+        return []<typename... Args>(std::type_identity<fuple<Args...>>)
+        {
+            std::array<size_t, sizeof...(Args)> offsets {};
+
+            if constexpr(sizeof...(Args) != 0)
+            {
+                using U = tail<base_t<T>, fuple_element_t<0, fuple<Args...>>>;
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+#endif
+                offsets[0] = offsetof(U, m);
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+                constexpr size_t sizes[] { sizeof(Args)... };
+                constexpr size_t aligns[] { alignof(Args)... };
+
+                for (size_t i = 1; i != sizeof...(Args); ++i)
+                     offsets[i] = (offsets[i - 1] + sizes[i - 1] + aligns[i] - 1) / aligns[i] * aligns[i];
+            }
+
+            return offsets;
+        }
+        (std::type_identity<own_t<T>>());
+    }
+
+    template <typename T>
+    inline constexpr auto own_offsets_v = own_offsets<T>();
+
+    template <typename T>
+    constexpr decltype(auto) own_fields(T&& t)
+    {
+        using U = std::remove_cvref_t<T>;
+
+        constexpr bool c = std::is_const_v<std::remove_reference_t<T>>;
+        auto p = reinterpret_cast<std::conditional_t<c, const std::byte*, std::byte*>>(std::addressof(t));
+
+        return [&]<typename... Args>(std::type_identity<fuple<Args...>>)
+        {
+            return [&]<size_t... N>(std::index_sequence<N...>)
+            {
+                return fmp::tie(*reinterpret_cast<std::conditional_t<c, const Args, Args>*>(p + own_offsets_v<U>[N])...);
+            }
+            (std::index_sequence_for<Args...>());
+        }
+        (std::type_identity<own_t<U>>());
+    }
+
+    template <size_t N>
+    inline constexpr auto ordinal = []
+    {
+        constexpr size_t n = [] { size_t n = 1; for (size_t i = N; i >= 10; i /= 10) ++n; return n; }();
+
+        std::array<char, n> s;
+
+        for (size_t i = N, k = n; k--; i /= 10)
+             s[k] = '0' + i % 10;
+
+        return s;
+    }();
+
     template <typename T>
     struct wrapper_t
     {
@@ -31,9 +280,14 @@ namespace fmp
     requires std::is_aggregate_v<T>
     consteval decltype(auto) arity()
     {
-        auto [...args] = T();
+        if constexpr(has_base_v<T>)
+            return arity<base_t<T>>() + fuple_size_v<own_t<T>>;
+        else
+        {
+            auto [...args] = T();
 
-        return sizeof...(args);
+            return sizeof...(args);
+        }
     }
 
     template <typename T>
@@ -43,9 +297,21 @@ namespace fmp
     requires std::is_aggregate_v<T>
     consteval decltype(auto) unpack()
     {
-        auto [...args] = T();
+        if constexpr(has_base_v<T>)
+        {
+            own_t<T> own {};
 
-        return forward_as_fuple(args...);
+            return fuple_cat(unpack<base_t<T>>(), fmp::apply([]<typename... Args>(Args&... args)
+            {
+                return forward_as_fuple(args...);
+            }, own));
+        }
+        else
+        {
+            auto [...args] = T();
+
+            return forward_as_fuple(args...);
+        }
     }
 
     template <typename T>
@@ -87,7 +353,12 @@ namespace fmp
     template <size_t N, typename T>
     consteval decltype(auto) member_name()
     {
-        return member_stem<member_address_v<N, T>>();
+        if constexpr(!has_base_v<T>)
+            return member_stem<member_address_v<N, T>>();
+        else if constexpr(N < arity<base_t<T>>())
+            return member_name<N, base_t<T>>();
+        else
+            return std::string_view(ordinal<N>.data(), ordinal<N>.size());
     }
 
     template <size_t N, typename T>
@@ -105,7 +376,7 @@ namespace fmp
     template <typename T, typename U>
     consteval decltype(auto) member_name()
     {
-        return member_stem<member_address_v<member_index_v<T, U>, U>>();
+        return member_name<member_index_v<T, U>, U>();
     }
 
     template <typename T>
@@ -125,10 +396,12 @@ namespace fmp
     template <typename S, typename T, typename... Args>
     constexpr size_t search_index(S&& s, T&& t, Args&&... args)
     {
-        if constexpr(sizeof...(Args) == 0)
-            return s != t;
-        else
-            return s == t ? 0 : search_index(std::forward<S>(s), std::forward<Args>(args)...) + 1;
+        size_t i = 0;
+
+        if (!(s == t || (... || (++i, s == args))))
+            ++i;
+
+        return i;
     }
 
     template <typename T>
@@ -177,17 +450,64 @@ namespace fmp
     {
         using U = std::remove_cvref_t<T>;
 
-        using type = decltype([]
+        using type = typename decltype([]
         {
-            auto [...args] = U();
+            if constexpr(has_base_v<U>)
+            {
+                return []<typename... Bases, typename... Args>(std::type_identity<fuple<Bases...>>, std::type_identity<fuple<Args...>>)
+                {
+                    return std::type_identity<pack<Bases..., Args...>>();
+                }
+                (std::type_identity<typename members<base_t<U>>::type>(), std::type_identity<own_t<U>>());
+            }
+            else
+            {
+                auto [...args] = U();
 
-            return pack<decltype(args)...>();
-        }());
+                return std::type_identity<pack<decltype(args)...>>();
+            }
+        }())::type;
     };
 
     template <typename T, template <typename ...> typename pack = fuple>
     using members_t = typename members<T, pack>::type;
 
+    // alignas and [[no_unique_address]] members are not accounted for
+
+    template <typename T>
+    consteval decltype(auto) offsets()
+    {
+        using U = std::remove_cvref_t<T>;
+
+        return []<typename... Args>(std::type_identity<fuple<Args...>>)
+        {
+            std::array<std::ptrdiff_t, sizeof...(Args)> offsets {};
+
+            if constexpr(has_base_v<U>)
+            {
+                constexpr auto b = fmp::offsets<base_t<U>>();
+                constexpr auto& o = own_offsets_v<U>;
+
+                std::copy(b.begin(), b.end(), offsets.begin());
+                std::copy(o.begin(), o.end(), offsets.begin() + b.size());
+            }
+            else if constexpr(sizeof...(Args) != 0)
+            {
+                constexpr std::ptrdiff_t sizes[] { sizeof(Args)... };
+                constexpr std::ptrdiff_t aligns[] { alignof(Args)... };
+
+                for (size_t i = 1; i != sizeof...(Args); ++i)
+                     offsets[i] = (offsets[i - 1] + sizes[i - 1] + aligns[i] - 1) / aligns[i] * aligns[i];
+            }
+
+            return offsets;
+        }
+        (std::type_identity<members_t<U>>());
+    }
+
+    template <typename T>
+    inline constexpr auto offsets_v = offsets<T>();
+
     template <typename T>
     using to_fuple_t = members_t<T>;
 
@@ -201,9 +521,20 @@ namespace fmp
 
         using type = decltype([]
         {
-            auto [...args] = U();
+            if constexpr(has_base_v<U>)
+            {
+                return []<typename... Args>(std::type_identity<fuple<Args...>>)
+                {
+                    return fuple<Args U::*...>();
+                }
+                (std::type_identity<typename members<U>::type>());
+            }
+            else
+            {
+                auto [...args] = U();
 
-            return fuple<decltype(args) U::*...>();
+                return fuple<decltype(args) U::*...>();
+            }
         }());
     };
 
@@ -213,14 +544,26 @@ namespace fmp
     template <size_t N, typename T>
     constexpr decltype(auto) offset_of() noexcept
     {
-        return visitor<members_t<std::remove_cvref_t<T>>>().template offset<N>();
+        return offsets_v<std::remove_cvref_t<T>>[N];
     }
 
     template <bool f, bool t, typename U>
     requires (!is_fuple_v<std::remove_cvref_t<U>> && !is_tuple_v<std::remove_cvref_t<U>>)
     static constexpr decltype(auto) expand(U&& u)
     {
-        return visitor<members_t<std::remove_cvref_t<U>>>().template get<f, t>(std::forward<U>(u));
+        using V = std::remove_cvref_t<U>;
+
+        if constexpr(has_base_v<V>)
+        {
+            using B = std::conditional_t<std::is_const_v<std::remove_reference_t<U>>, const base_t<V>, base_t<V>>;
+
+            return fmp::apply([]<typename... Args>(Args&... args)
+            {
+                return visitor<members_t<V>>::template make<f, t>(args...);
+            }, fuple_cat(expand<1, 1>(static_cast<B&>(u)), own_fields(u)));
+        }
+        else
+            return visitor<members_t<V>>().template get<f, t>(std::forward<U>(u));
     }
 
     template <typename T>
@@ -300,6 +643,40 @@ namespace fmp
         return fmp::apply(std::forward<F>(f), tie_fuple(std::forward<T>(t)));
     }
 
+    template <typename T>
+    struct is_variant : std::false_type
+    {
+    };
+
+    template <typename... Args>
+    struct is_variant<std::variant<Args...>> : std::true_type
+    {
+    };
+
+    template <typename T>
+    inline constexpr auto is_variant_v = is_variant<T>::value;
+
+    template <typename T>
+    inline constexpr auto is_record_v = std::is_class_v<T> && !requires (T t)
+    {
+        requires std::is_pointer_v<T> || requires { typename T::weak_type; } || requires { t.has_value(); } ||
+                 requires { t.begin(); t.end(); } || requires { t.first; t.second; } || is_variant_v<T>;
+    };
+
+    template <typename T>
+    constexpr decltype(auto) fields(T&& t)
+    {
+        if constexpr(is_tuple_v<std::remove_cvref_t<T>>)
+            return std::apply([]<typename... Args>(Args&... args){ return fmp::tie(args...); }, t);
+        else if constexpr(is_fuple_v<std::remove_cvref_t<T>>)
+            return fmp::apply([]<typename... Args>(Args&... args){ return fmp::tie(args...); }, t);
+        else
+            return tie_fuple(std::forward<T>(t));
+    }
+
+    template <typename T>
+    inline constexpr size_t fields_v = length_v<decltype(fields(std::declval<T&>()))>;
+
     template <auto... N, typename T>
     constexpr decltype(auto) choose(T&& t)
     {
@@ -341,25 +718,284 @@ namespace fmp
         if constexpr(B && requires { s.resize(0); })
             s.resize(l + size);
 
-        auto dst = (void*)(s.data() + l);
-        auto src = (void*)std::addressof(std::forward<T>(t));
+        auto dst = (void*)(s.data() + l);
+        auto src = (void*)std::addressof(std::forward<T>(t));
+
+        if constexpr(B)
+            std::memcpy(dst, src, size);
+        else
+            std::memcpy(src, dst, size);
+
+        return size;
+    }
+
+    template <size_t N>
+    constexpr decltype(auto) byteswap(void* data, size_t n)
+    {
+        auto p = static_cast<unsigned char*>(data);
+
+        using I = std::conditional_t<N == 2, uint16_t, std::conditional_t<N == 4, uint32_t, uint64_t>>;
+
+        for (size_t i = 0; i != n; ++i, p += N)
+        {
+             if constexpr(N == 2 || N == 4 || N == 8)
+             {
+                 I v;
+
+                 std::memcpy(&v, p, N);
+                 v = std::byteswap(v);
+                 std::memcpy(p, &v, N);
+             }
+             else
+                 std::reverse(p, p + N);
+        }
+    }
+
+    constexpr uint64_t hash(std::string_view s, uint64_t h = 0xcbf29ce484222325)
+    {
+        for (auto c : s)
+             h = (h ^ uint8_t(c)) * 0x100000001b3;
+
+        return h;
+    }
+
+    // specialize member_tags_v to pin explicit tag ids
+
+    template <typename T>
+    consteval decltype(auto) member_tags()
+    {
+        if constexpr(requires (T t) { t.first; t.second; })
+            return std::array<uint32_t, 2>{ 0, 1 };
+        else if constexpr(is_fuple_v<T> || is_tuple_v<T>)
+        {
+            return [&]<size_t... N>(std::index_sequence<N...>)
+            {
+                return std::array<uint32_t, sizeof...(N)>{ N... };
+            }
+            (std::make_index_sequence<std::conditional_t<is_fuple_v<T>, fuple_size<T>, std::tuple_size<T>>::value>());
+        }
+        else
+        {
+            return apply([&]<typename... Args>(Args&&... args)
+            {
+                return std::array<uint32_t, sizeof...(Args)>{ uint32_t(hash(args) ^ hash(args) >> 32)... };
+            }, member_names_v<T>);
+        }
+    }
+
+    template <typename T>
+    inline constexpr auto member_tags_v = member_tags<T>();
+
+    template <typename T>
+    consteval bool unique_tags()
+    {
+        auto tags = member_tags_v<T>;
+        std::sort(tags.begin(), tags.end());
+
+        return std::adjacent_find(tags.begin(), tags.end()) == tags.end();
+    }
+
+    template <typename T>
+    struct is_string : std::false_type
+    {
+    };
+
+    template <typename C, typename T, typename A>
+    struct is_string<std::basic_string<C, T, A>> : std::true_type
+    {
+    };
+
+    template <typename T>
+    inline constexpr auto is_string_v = is_string<T>::value;
+
+    constexpr uint64_t mix(uint64_t v, uint64_t h)
+    {
+        for (size_t i = 0; i != sizeof(v); ++i)
+             h = (h ^ uint8_t(v >> i * 8)) * 0x100000001b3;
+
+        return h;
+    }
+
+    // type names come from the compiler, fingerprints are only comparable between builds of the same one
+
+    template <typename T, typename... Args>
+    consteval uint64_t schema_hash()
+    {
+        using U = std::remove_cvref_t<T>;
+
+        if constexpr((std::is_same_v<U, Args> || ...))
+            return hash("^");
+        else if constexpr(std::is_enum_v<U> || std::is_fundamental_v<U>)
+            return hash(type_name_v<U>);
+        else if constexpr(std::is_array_v<U>)
+            return mix(mix(schema_hash<std::remove_extent_t<U>, U, Args...>(), std::extent_v<U>), hash("[N]"));
+        else if constexpr(std::is_pointer_v<U> || requires { typename U::weak_type; })
+            return mix(schema_hash<decltype(*std::declval<U>()), U, Args...>(), hash("*"));
+        else if constexpr(requires { std::declval<U>().has_value(); })
+            return mix(schema_hash<typename U::value_type, U, Args...>(), hash("?"));
+        else if constexpr(is_variant_v<U>)
+        {
+            return [&]<typename... Alternatives>(std::type_identity<std::variant<Alternatives...>>)
+            {
+                uint64_t h = hash("|");
+                ((h = mix(schema_hash<Alternatives, U, Args...>(), h)), ...);
+
+                return h;
+            }
+            (std::type_identity<U>());
+        }
+        else if constexpr(requires { std::declval<U>().begin(); std::declval<U>().end(); })
+        {
+            if constexpr(is_string_v<U>)
+                return hash(type_name_v<U>);
+            else if constexpr(requires { typename U::mapped_type; })
+                return mix(schema_hash<typename U::mapped_type, U, Args...>(), mix(schema_hash<typename U::key_type, U, Args...>(), hash("{:}")));
+            else
+                return mix(schema_hash<typename U::value_type, U, Args...>(), hash("[]"));
+        }
+        else if constexpr(std::is_class_v<U>)
+        {
+            uint64_t h = hash("{");
+
+            constexpr bool positional = is_fuple_v<U> || is_tuple_v<U> || requires { std::declval<U>().first; std::declval<U>().second; };
+
+            if constexpr(!positional)
+            {
+                apply([&]<typename... Names>(Names&&... names)
+                {
+                    ((h = mix(hash(names), h)), ...);
+                }, member_names_v<U>);
+            }
+
+            auto fold = [&]<template <typename ...> typename F, typename... Members>(std::type_identity<F<Members...>>)
+            {
+                ((h = mix(schema_hash<Members, U, Args...>(), h)), ...);
+            };
+
+            if constexpr(positional)
+                fold(std::type_identity<U>());
+            else
+                fold(std::type_identity<members_t<U>>());
+
+            return mix(hash("}"), h);
+        }
+        else
+            return hash(type_name_v<U>);
+    }
+
+    template <typename T>
+    inline constexpr auto schema_hash_v = schema_hash<T>();
+
+    template <typename T>
+    inline constexpr auto is_bulk_v = requires (T t)
+    {
+        t.data();
+        requires std::is_fundamental_v<std::remove_cvref_t<decltype(*t.data())>> || std::is_enum_v<std::remove_cvref_t<decltype(*t.data())>>;
+    };
+
+    // tuples are left out as libstdc++ lays their elements out in reverse
+
+    template <typename T>
+    consteval size_t dense_size()
+    {
+        if constexpr(std::is_enum_v<T> || std::is_fundamental_v<T>)
+            return sizeof(T);
+        else if constexpr(std::is_array_v<T>)
+            return dense_size<std::remove_extent_t<T>>() * std::extent_v<T>;
+        else if constexpr(std::is_trivially_copy_constructible_v<T> && std::is_trivially_destructible_v<T> &&
+                         ((std::is_aggregate_v<T> && is_record_v<T> && !is_fuple_v<T>) || requires (T t) { t.first; t.second; }))
+        {
+            return []<typename... Args>(std::type_identity<fuple<Args&...>>)
+            {
+                size_t size = ((dense_size<Args>() ? dense_size<Args>() : sizeof(T) + 1) + ... + 0);
+
+                return size == sizeof(T) ? size : 0;
+            }
+            (std::type_identity<decltype(fields(std::declval<T&>()))>());
+        }
+        else
+            return 0;
+    }
+
+    template <typename T>
+    inline constexpr auto is_dense_v = !std::is_array_v<T> && dense_size<T>() != 0;
+
+    template <bool C, typename P = policy>
+    struct assigner
+    {
+        P& p;
+
+        template <typename T, typename F>
+        constexpr decltype(auto) allocate(T&& t, F&& f)
+        {
+            if constexpr(! requires { p.allocate(0); })
+                f();
+            else if constexpr(requires { t.capacity(); })
+            {
+                size_t capacity = t.capacity();
+                f();
+
+                p.allocate(t.capacity() != capacity);
+            }
+            else
+            {
+                size_t size = std::distance(t.begin(), t.end());
+                f();
+
+                size_t grow = std::distance(t.begin(), t.end());
+                p.allocate(grow > size ? grow - size : 0);
+            }
+        }
+
+        template <typename V, typename T>
+        constexpr decltype(auto) make(T&& t)
+        {
+            if constexpr(requires { p.template make<V>(t); })
+                return p.template make<V>(t);
+            else
+                return V();
+        }
+
+        template <bool B, typename U, typename L, typename S, typename T>
+        constexpr decltype(auto) transfer(L&& l, S&& s, T&& t, size_t size = sizeof(U))
+        {
+            size = copy<C, B, U>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t), size);
+
+            if constexpr(C && sizeof(U) > 1 && requires { requires P::order != std::endian::native; })
+            {
+                if constexpr(B)
+                    byteswap<sizeof(U)>((void*)(s.data() + l), size / sizeof(U));
+                else
+                    byteswap<sizeof(U)>((void*)std::addressof(t), size / sizeof(U));
+            }
+
+            if constexpr(C && B && requires { p.digest(s.data(), size); } && ! requires { requires P::tagging; })
+                p.digest(s.data() + l, size);
+
+            return size;
+        }
+
+        template <typename U, typename S>
+        constexpr decltype(auto) patch(S&& s, size_t k, U u)
+        {
+            std::memcpy((void*)(s.data() + k), &u, sizeof(U));
 
-        if constexpr(B)
-            std::memcpy(dst, src, size);
-        else
-            std::memcpy(src, dst, size);
+            if constexpr(requires { requires P::order != std::endian::native; })
+                byteswap<sizeof(U)>((void*)(s.data() + k), 1);
+        }
 
-        return size;
-    }
+        template <typename U>
+        static constexpr bool dense = requires (U t)
+        {
+            requires is_dense_v<std::remove_cvref_t<decltype(*t.data())>>;
+            requires ! requires { requires P::order != std::endian::native; };
+        };
 
-    template <bool C>
-    struct assigner
-    {
         template <bool B, typename L, typename S, typename T>
         constexpr decltype(auto) seq(L&& l, S&& s, T&& t, size_t size)
         {
             if constexpr(!B && requires { t.resize(0); })
-                t.resize(size);
+                allocate(t, [&]{ t.resize(size); });
 
             for (auto& v : t)
                  replicate<B>(std::forward<L>(l), std::forward<S>(s), v);
@@ -388,79 +1024,422 @@ namespace fmp
         template <bool B, typename U, typename L, typename S, typename T>
         constexpr decltype(auto) assign(L&& l, S&& s, T&& t)
         {
-            for (auto& p : t)
+            for (auto&& e : t)
             {
                  if constexpr(! requires { typename U::mapped_type; })
-                     replicate<B>(std::forward<L>(l), std::forward<S>(s), p);
+                     replicate<B>(std::forward<L>(l), std::forward<S>(s), e);
                  else
                  {
-                     replicate<B>(std::forward<L>(l), std::forward<S>(s), p.first);
-                     replicate<B>(std::forward<L>(l), std::forward<S>(s), p.second);
+                     replicate<B>(std::forward<L>(l), std::forward<S>(s), e.first);
+                     replicate<B>(std::forward<L>(l), std::forward<S>(s), e.second);
                  }
             }
         }
 
+        template <typename U, typename T, typename... Args>
+        constexpr decltype(auto) hint(T&& t, Args&&... args)
+        {
+            if constexpr(requires { typename U::key_compare; })
+                t.emplace_hint(t.end(), std::forward<Args>(args)...);
+            else
+                t.emplace(std::forward<Args>(args)...);
+        }
+
+        template <bool B, typename U, typename L, typename S, typename T>
+        constexpr decltype(auto) emplace(L&& l, S&& s, T&& t)
+        {
+            auto key = make<typename U::key_type>(t);
+            replicate<B>(std::forward<L>(l), std::forward<S>(s), key);
+
+            if constexpr(! requires { typename U::mapped_type; })
+                hint<U>(t, std::move(key));
+            else
+            {
+                auto val = make<typename U::mapped_type>(t);
+                replicate<B>(std::forward<L>(l), std::forward<S>(s), val);
+
+                hint<U>(t, std::move(key), std::move(val));
+            }
+
+            if constexpr(requires { p.allocate(0); })
+                p.allocate(1);
+        }
+
+        template <bool B, typename U, typename L, typename S, typename T, typename N>
+        constexpr decltype(auto) recycle(L&& l, S&& s, T&& t, N&& nodes)
+        {
+            if (nodes.empty())
+                return emplace<B, U>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t));
+
+            auto node = nodes.extract(nodes.begin());
+
+            if constexpr(! requires { typename U::mapped_type; })
+                replicate<B>(std::forward<L>(l), std::forward<S>(s), node.value());
+            else
+            {
+                replicate<B>(std::forward<L>(l), std::forward<S>(s), node.key());
+                replicate<B>(std::forward<L>(l), std::forward<S>(s), node.mapped());
+            }
+
+            if constexpr(requires { typename U::key_compare; })
+                t.insert(t.end(), std::move(node));
+            else
+                t.insert(std::move(node));
+        }
+
+        template <bool B, typename U, typename L, typename S, typename T>
+        constexpr decltype(auto) flat(L&& l, S&& s, T&& t, size_t size)
+        {
+            auto c = std::move(t).extract();
+
+            if constexpr(! requires { typename U::mapped_type; })
+            {
+                if constexpr(requires { p.rebind(c); })
+                    p.rebind(c);
+
+                seq<B>(std::forward<L>(l), std::forward<S>(s), c, size);
+                t.replace(std::move(c));
+            }
+            else
+            {
+                if constexpr(requires { p.rebind(c.keys); })
+                {
+                    p.rebind(c.keys);
+                    p.rebind(c.values);
+                }
+
+                allocate(c.keys, [&]{ c.keys.resize(size); });
+                allocate(c.values, [&]{ c.values.resize(size); });
+
+                for (size_t i = 0; i != size; ++i)
+                {
+                     replicate<B>(std::forward<L>(l), std::forward<S>(s), c.keys[i]);
+                     replicate<B>(std::forward<L>(l), std::forward<S>(s), c.values[i]);
+                }
+
+                t.replace(std::move(c.keys), std::move(c.values));
+            }
+        }
+
         template <bool B, typename U, typename L, typename S, typename T>
         constexpr decltype(auto) assign(L&& l, S&& s, T&& t, size_t size)
         {
-            for (size_t i = 0; i != size; ++i)
+            if constexpr(requires { t.replace(std::move(t).extract()); } ||
+                         requires { t.replace(std::move(t).extract().keys, std::move(t).extract().values); })
+                flat<B, U>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t), size);
+            else if constexpr(! requires { requires P::recycle; t.extract(t.begin()); })
+            {
+                for (size_t i = 0; i != size; ++i)
+                     emplace<B, U>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t));
+            }
+            else
             {
-                 typename U::key_type key;
-                 replicate<B>(std::forward<L>(l), std::forward<S>(s), key);
+                U nodes = std::move(t);
+                t.clear();
 
-                 if constexpr(! requires { typename U::mapped_type; })
-                     t.emplace(key);
-                 else
-                 {
-                     typename U::mapped_type val;
-                     replicate<B>(std::forward<L>(l), std::forward<S>(s), val);
+                if constexpr(requires { t.reserve(size); })
+                    t.reserve(size);
 
-                     t.emplace(key, val);
-                 }
+                for (size_t i = 0; i != size; ++i)
+                     recycle<B, U>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t), nodes);
             }
         }
 
         template <bool B, typename L, typename S, typename T>
         constexpr decltype(auto) assign(L&& l, S&& s, T&& t, size_t size)
         {
-            if constexpr(!B)
-                t.resize(size);
+            using V = std::remove_cvref_t<decltype(*t.data())>;
+
+            size_t n = size;
+
+            // a range that cannot be resized takes no more elements than it holds, the rest are skipped
+
+            if constexpr(!B && requires { t.resize(0); })
+                allocate(t, [&]{ t.resize(size); });
+            else if constexpr(!B)
+                n = std::min<size_t>(size, t.size());
+
+            if (n)
+                transfer<B, V>(std::forward<L>(l), std::forward<S>(s), *t.data(), n * sizeof(V));
 
-            l += copy<C, B, size_t>(std::forward<L>(l), std::forward<S>(s), t[0], size);
+            l += size * sizeof(V);
         }
 
         template <bool B, typename L, typename S, typename T>
-        constexpr decltype(auto) assign(L&& l, S&& s, T&& t)
+        constexpr decltype(auto) tagged(L&& l, S&& s, T&& t)
         {
-            fmp::for_each([&]<typename U>(U&& u)
+            using U = std::remove_cvref_t<T>;
+
+            constexpr auto tags = member_tags_v<U>;
+
+            static_assert(tags.size() == fields_v<U>, "every member needs exactly one tag");
+            static_assert(unique_tags<U>(), "member tags must be unique");
+
+            if constexpr(C && B && requires { s.resize(0); })
+                l = s.length();
+
+            uint32_t n = fields_v<U>;
+            l += transfer<B, uint32_t>(std::forward<L>(l), std::forward<S>(s), n);
+
+            auto entry = [&]<typename V>(uint32_t tag, V&& v, size_t i)
             {
                 if constexpr(C && B && requires { s.resize(0); })
                     l = s.length();
 
-                replicate<B>(std::forward<L>(l), std::forward<S>(s), std::forward<U>(u));
+                l += transfer<B, uint32_t>(std::forward<L>(l), std::forward<S>(s), tag);
+
+                uint32_t length = 0;
+                size_t k = l;
+
+                l += transfer<B, uint32_t>(std::forward<L>(l), std::forward<S>(s), length);
+
+                if constexpr(requires { p.template enter<U>(l, i); })
+                    p.template enter<U>(l, i);
+
+                replicate<B>(std::forward<L>(l), std::forward<S>(s), std::forward<V>(v));
+
+                if constexpr(requires { p.leave(l); })
+                    p.leave(l);
+
+                if constexpr(B)
+                {
+                    length = l - k - sizeof(length);
+
+                    if constexpr(C)
+                        patch(s, k, length);
+                }
+                else
+                    l = k + sizeof(length) + length;
+            };
+
+            size_t m = 0;
+
+            fmp::for_each([&, i = size_t(0)]<typename V>(V&& v) mutable
+            {
+                if constexpr(B)
+                    entry(tags[i], std::forward<V>(v), i);
+                else if (m == i && m != n)
+                {
+                    uint32_t tag = 0;
+                    transfer<B, uint32_t>(std::forward<L>(l), std::forward<S>(s), tag);
+
+                    if (tag == tags[i])
+                    {
+                        entry(tag, std::forward<V>(v), i);
+                        ++m;
+                    }
+                }
+
+                ++i;
             }, std::forward<T>(t));
 
+            if constexpr(!B)
+            {
+                for (; m != n; ++m)
+                {
+                     uint32_t tag = 0;
+                     transfer<B, uint32_t>(std::forward<L>(l), std::forward<S>(s), tag);
+
+                     bool found = false;
+
+                     fmp::for_each([&, i = size_t(0)]<typename V>(V&& v) mutable
+                     {
+                         if (!found && tags[i] == tag)
+                         {
+                             entry(tag, std::forward<V>(v), i);
+                             found = true;
+                         }
+
+                         ++i;
+                     }, std::forward<T>(t));
+
+                     if (!found)
+                     {
+                         uint32_t length = 0;
+
+                         l += sizeof(tag);
+                         l += transfer<B, uint32_t>(std::forward<L>(l), std::forward<S>(s), length) + length;
+                     }
+                }
+            }
+        }
+
+        template <bool B, typename L, typename S, typename T>
+        constexpr decltype(auto) assign(L&& l, S&& s, T&& t)
+        {
+            using U = std::remove_cvref_t<T>;
+
+            if constexpr(requires { requires P::tagging; })
+                tagged<B>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t));
+            else
+            {
+                fmp::for_each([&, i = size_t(0)]<typename V>(V&& v) mutable
+                {
+                    if constexpr(C && B && requires { s.resize(0); })
+                        l = s.length();
+
+                    if constexpr(requires { p.template enter<U>(l, i); })
+                        p.template enter<U>(l, i++);
+
+                    replicate<B>(std::forward<L>(l), std::forward<S>(s), std::forward<V>(v));
+
+                    if constexpr(requires { p.leave(l); })
+                        p.leave(l);
+                }, std::forward<T>(t));
+            }
+
             if constexpr(B)
                 return std::forward<S>(s);
             else
                 return std::forward<T>(t);
         }
 
+        template <bool B, typename L, typename S, typename T>
+        constexpr decltype(auto) process(L&& l, S&& s, T&& t)
+        {
+            if constexpr(requires { p.corrupted = true; })
+            {
+                uint64_t length = 0;
+                uint32_t crc = 0;
+
+                if constexpr(C && B && requires { s.resize(0); })
+                    l = s.length();
+
+                if constexpr(C && !B)
+                {
+                    if (s.size() - std::min<size_t>(l, s.size()) < sizeof(length) + sizeof(crc))
+                    {
+                        p.corrupted = true;
+                        l = s.size();
+
+                        return std::forward<T>(t);
+                    }
+                }
+
+                size_t k = l;
+
+                l += transfer<B, uint64_t>(std::forward<L>(l), std::forward<S>(s), length);
+                l += transfer<B, uint32_t>(std::forward<L>(l), std::forward<S>(s), crc);
+
+                if constexpr(B)
+                {
+                    p.crc = 0;
+                    stamp<B>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t));
+
+                    length = l - k - sizeof(length) - sizeof(crc);
+
+                    if constexpr(C)
+                    {
+                        if constexpr(requires { requires P::tagging; })
+                            p.crc = crc32c(s.data() + k + sizeof(length) + sizeof(crc), length);
+
+                        patch(s, k, length);
+                        patch(s, k + sizeof(length), p.crc);
+                    }
+
+                    return std::forward<S>(s);
+                }
+                else
+                {
+                    p.corrupted = length > s.size() - std::min<size_t>(l, s.size()) || crc32c(s.data() + l, length) != crc;
+
+                    if (p.corrupted)
+                        l = std::min<size_t>(l + length, s.size());
+                    else
+                        stamp<B>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t));
+
+                    return std::forward<T>(t);
+                }
+            }
+            else
+                return stamp<B>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t));
+        }
+
+        template <bool B, typename L, typename S, typename T>
+        constexpr decltype(auto) stamp(L&& l, S&& s, T&& t)
+        {
+            if constexpr(requires { p.rejected = true; })
+            {
+                constexpr uint64_t hash = schema_hash_v<T>;
+
+                uint64_t header = hash;
+
+                if constexpr(C && B && requires { s.resize(0); })
+                    l = s.length();
+
+                l += transfer<B, uint64_t>(std::forward<L>(l), std::forward<S>(s), header);
+
+                if constexpr(!B)
+                {
+                    p.rejected = header != hash;
+
+                    if (p.rejected)
+                        return std::forward<T>(t);
+                }
+            }
+
+            return replicate<B>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t));
+        }
+
         template <bool B, typename L, typename S, typename T>
         constexpr decltype(auto) replicate(L&& l, S&& s, T&& t)
         {
             using U = std::remove_cvref_t<T>;
 
             if constexpr(std::is_enum_v<U> || std::is_fundamental_v<U>)
-                l += copy<C, B, U>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t));
+                l += transfer<B, U>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t));
+            else if constexpr(std::is_array_v<U>)
+            {
+                using E = std::remove_all_extents_t<U>;
+
+                if constexpr(std::is_enum_v<E> || std::is_fundamental_v<E>)
+                    l += transfer<B, E>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t), sizeof(U));
+                else if constexpr(is_dense_v<E> && ! requires { requires P::order != std::endian::native; })
+                    l += transfer<B, char>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t), sizeof(U));
+                else
+                {
+                    for (auto& e : t)
+                         replicate<B>(std::forward<L>(l), std::forward<S>(s), e);
+                }
+            }
             else if constexpr(std::is_pointer_v<U> || requires { typename U::weak_type; })
             {
                 if constexpr(!B)
                 {
-                    if constexpr(std::is_pointer_v<U>)
-                        t = new std::remove_pointer_t<U>();
-                    else
-                        t = std::make_shared<typename U::element_type>();
+                    using E = std::remove_cvref_t<decltype(*t)>;
+
+                    bool reuse = false;
+
+                    // a non null raw pointer is taken to own a valid object, which is decoded into
+
+                    if constexpr(requires { requires P::recycle; })
+                    {
+                        if constexpr(std::is_pointer_v<U>)
+                            reuse = t;
+                        else
+                            reuse = t.use_count() == 1;
+                    }
+
+                    if (!reuse)
+                    {
+                        if constexpr(std::is_pointer_v<U>)
+                        {
+                            if constexpr(requires { p.template create<E>(); })
+                                t = p.template create<E>();
+                            else
+                                t = new E();
+                        }
+                        else
+                        {
+                            if constexpr(requires { p.template share<E>(); })
+                                t = p.template share<E>();
+                            else
+                                t = std::make_shared<E>();
+                        }
+
+                        if constexpr(requires { p.allocate(0); })
+                            p.allocate(1);
+                    }
                 }
 
                 replicate<B>(std::forward<L>(l), std::forward<S>(s), *t);
@@ -468,15 +1447,25 @@ namespace fmp
             else if constexpr(requires { t.has_value(); })
             {
                 bool size = t.has_value();
-                l += copy<C, B, bool>(std::forward<L>(l), std::forward<S>(s), size);
+                l += transfer<B, bool>(std::forward<L>(l), std::forward<S>(s), size);
 
                 if (size)
                 {
                     if constexpr(!B)
-                        t = typename std::remove_cvref_t<T>::value_type();
+                    {
+                        if constexpr(requires { requires P::recycle; })
+                        {
+                            if (!t)
+                                t.emplace();
+                        }
+                        else
+                            t = typename std::remove_cvref_t<T>::value_type();
+                    }
 
                     replicate<B>(std::forward<L>(l), std::forward<S>(s), *t);
                 }
+                else if constexpr(!B)
+                    t.reset();
             }
             else if constexpr(requires { t.begin(); t.end(); })
             {
@@ -487,13 +1476,38 @@ namespace fmp
                 else
                     size = B * std::distance(t.begin(), t.end());
 
-                l += copy<C, B, size_t>(std::forward<L>(l), std::forward<S>(s), size);
+                l += transfer<B, size_t>(std::forward<L>(l), std::forward<S>(s), size);
+
+                if constexpr(!B && requires { p.rebind(t); })
+                    p.rebind(t);
 
-                if constexpr(std::is_same_v<U, std::string>)
+                if constexpr(is_string_v<U> || is_bulk_v<U> || dense<U>)
                     assign<B>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t), size);
                 else
                     browse<B>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t), size);
             }
+            else if constexpr(is_variant_v<U>)
+            {
+                uint32_t index = t.index();
+                l += transfer<B, uint32_t>(std::forward<L>(l), std::forward<S>(s), index);
+
+                constexpr auto table = []<size_t... N>(std::index_sequence<N...>)
+                {
+                    return std::array{ &assigner::alternative<B, N, L, S, T>... };
+                }
+                (std::make_index_sequence<std::variant_size_v<U>>());
+
+                if (index < table.size())
+                    (this->*table[index])(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t));
+                else if constexpr(!B)
+                {
+                    if constexpr(requires { p.corrupted = true; })
+                        p.corrupted = true;
+
+                    if constexpr(std::is_default_constructible_v<U>)
+                        t = U();
+                }
+            }
             else if constexpr(std::is_class_v<U>)
                 assign<B>(std::forward<L>(l), std::forward<S>(s), std::forward<T>(t));
 
@@ -502,21 +1516,63 @@ namespace fmp
             else
                 return std::forward<T>(t);
         }
+
+        template <bool B, size_t N, typename L, typename S, typename T>
+        constexpr void alternative(L&& l, S&& s, T&& t)
+        {
+            if constexpr(!B)
+            {
+                if constexpr(requires { requires P::recycle; })
+                {
+                    if (t.index() != N)
+                        t.template emplace<N>();
+                }
+                else
+                    t.template emplace<N>();
+            }
+
+            replicate<B>(std::forward<L>(l), std::forward<S>(s), *std::get_if<N>(&t));
+        }
     };
 
-    template <typename T>
-    constexpr decltype(auto) size_bytes(T&& t)
+    template <typename T, typename P>
+    requires is_policy_v<P>
+    constexpr decltype(auto) size_bytes(T&& t, P&& p)
     {
         size_t l = 0;
-        assigner<0>().replicate<1>(l, std::string_view(), std::forward<T>(t));
+        assigner<0, std::remove_reference_t<P>>{p}.template process<1>(l, std::string_view(), std::forward<T>(t));
 
         return l;
     }
 
+    template <typename T>
+    constexpr decltype(auto) size_bytes(T&& t)
+    {
+        return size_bytes(std::forward<T>(t), policy());
+    }
+
+    template <typename S, typename T, typename P>
+    requires is_policy_v<P>
+    constexpr decltype(auto) marshal(S&& s, T&& t, P&& p)
+    {
+        return assigner<1, std::remove_reference_t<P>>{p}.template process<1>(0, std::forward<S>(s), std::forward<T>(t));
+    }
+
     template <typename S, typename T>
+    requires (!is_policy_v<T>)
     constexpr decltype(auto) marshal(S&& s, T&& t)
     {
-        return assigner<1>().replicate<1>(0, std::forward<S>(s), std::forward<T>(t));
+        return marshal(std::forward<S>(s), std::forward<T>(t), policy());
+    }
+
+    template <typename T, typename P>
+    requires is_policy_v<P>
+    constexpr decltype(auto) marshal(T&& t, P&& p)
+    {
+        std::string s;
+        marshal(s, std::forward<T>(t), std::forward<P>(p));
+
+        return s;
     }
 
     template <typename T>
@@ -531,7 +1587,7 @@ namespace fmp
     template <typename T>
     constexpr decltype(auto) marshal()
     {
-        T t;
+        T t {};
 
         return marshal(t);
     }
@@ -554,7 +1610,7 @@ namespace fmp
     template <size_t lower, size_t upper, typename T>
     constexpr decltype(auto) marshal()
     {
-        T t;
+        T t {};
 
         return marshal<lower, upper>(t);
     }
@@ -568,13 +1624,31 @@ namespace fmp
         return s;
     }
 
+    template <typename S, typename T, typename P>
+    requires is_policy_v<P>
+    constexpr decltype(auto) unmarshal(size_t& l, S&& s, T&& t, P&& p)
+    {
+        return assigner<1, std::remove_reference_t<P>>{p}.template process<0>(l, std::forward<S>(s), std::forward<T>(t));
+    }
+
     template <typename S, typename T>
     constexpr decltype(auto) unmarshal(size_t& l, S&& s, T&& t)
     {
-        return assigner<1>().replicate<0>(l, std::forward<S>(s), std::forward<T>(t));
+        return unmarshal(l, std::forward<S>(s), std::forward<T>(t), policy());
+    }
+
+    template <typename S, typename T, typename P>
+    requires is_policy_v<P>
+    constexpr decltype(auto) unmarshal(S&& s, T&& t, P&& p)
+    {
+        size_t l = 0;
+        unmarshal(l, std::forward<S>(s), std::forward<T>(t), std::forward<P>(p));
+
+        return std::forward<T>(t);
     }
 
     template <typename S, typename T>
+    requires (!is_policy_v<T>)
     constexpr decltype(auto) unmarshal(S&& s, T&& t)
     {
         size_t l = 0;
@@ -583,10 +1657,20 @@ namespace fmp
         return std::forward<T>(t);
     }
 
+    template <typename T, typename S, typename P>
+    requires is_policy_v<P>
+    constexpr decltype(auto) unmarshal(S&& s, P&& p)
+    {
+        T t {};
+        unmarshal(std::forward<S>(s), t, std::forward<P>(p));
+
+        return t;
+    }
+
     template <typename T, typename S>
     constexpr decltype(auto) unmarshal(S&& s)
     {
-        T t;
+        T t {};
         unmarshal(std::forward<S>(s), t);
 
         return t;
@@ -610,7 +1694,7 @@ namespace fmp
     template <size_t lower, size_t upper, typename T, typename S>
     constexpr decltype(auto) unmarshal(S&& s)
     {
-        T t;
+        T t {};
         unmarshal<lower, upper>(std::forward<S>(s), t);
 
         return t;
@@ -643,7 +1727,7 @@ namespace fmp
     template <typename T, auto... N>
     constexpr decltype(auto) serialize()
     {
-        T t;
+        T t {};
 
         return serialize<N...>(t);
     }
@@ -666,7 +1750,7 @@ namespace fmp
     template <typename T, auto... N, typename S>
     constexpr decltype(auto) deserialize(S&& s)
     {
-        T t;
+        T t {};
         deserialize<N...>(std::forward<S>(s), t);
 
         return t;
@@ -716,7 +1800,10 @@ namespace fmp
     template <size_t N, typename T, typename U = members_t<T>, typename V = visitor<U>>
     constexpr decltype(auto) get(V v = V())
     {
-        return std::bit_cast<fuple_element_t<N, U> T::*>(v.template offset<N>());
+        if constexpr(has_base_v<T>)
+            return std::bit_cast<fuple_element_t<N, U> T::*>(offset_of<N, T>());
+        else
+            return std::bit_cast<fuple_element_t<N, U> T::*>(v.template offset<N>());
     }
 
     template <size_t N, typename T>
@@ -742,23 +1829,43 @@ namespace fmp
         return fmp::for_each(std::forward<F>(f), member_pointers_v<std::remove_cvref_t<T>>);
     }
 
+    // a member pointer holds no offset in a constant expression, there the members of an object are compared
+
     template <typename R, typename T>
     constexpr size_t index(R T::* m)
     {
-        static constexpr T t{};
-        decltype(auto) p = &(t.*m);
-
-        return apply([&](auto&...e)
+        if consteval
         {
-            size_t i = 0;
+            T t {};
+            decltype(auto) p = &(t.*m);
+
+            return apply([&](auto&... e)
+            {
+                size_t i = 0;
 
-            for (auto m : { (void*)&e ... })
-                 if (i += m != p; m == p)
-                     break;
+                if (!(... || ((void*)&e == p || (++i, false))))
+                    i = sizeof...(e);
+
+                return i;
+            }, tie_fuple(t));
+        }
+
+        constexpr auto& o = offsets_v<T>;
+
+        auto i = std::lower_bound(o.begin(), o.end(), std::bit_cast<std::ptrdiff_t>(m));
+
+        return i != o.end() && *i == std::bit_cast<std::ptrdiff_t>(m) ? i - o.begin() : o.size();
+    }
+
+    template <auto m>
+    inline constexpr size_t index_v = []<typename R, typename T>(R T::*)
+    {
+        constexpr size_t i = member_index<T>(member_stem<m>());
+        static_assert(i != arity_v<T>, "the member has no name, it is an own member of a record with a base");
 
-            return i;
-        }, tie_fuple(t));
+        return i;
     }
+    (m);
 
     template <typename T>
     using io_t = element<0, T>;
@@ -782,26 +1889,32 @@ namespace fmp
     requires (is_fuple_v<std::remove_cvref_t<T>>)
     constexpr static S& apply(S& s, T&& t)
     {
-        if constexpr(!!lower)
+        auto field = [&](auto&& v, bool first)
         {
-            if constexpr(B)
-                s << ", ";
-            else
+            if (!first)
             {
-                char c;
-                s >> c >> c;
+                if constexpr(B)
+                    s << ", ";
+                else
+                {
+                    char c;
+                    s >> c >> c;
+                }
             }
-        }
 
-        if constexpr(B)
-            s << fmp::quoted(fmp::get<lower>(std::forward<T>(t)));
-        else
-            s >> fmp::quoted(fmp::get<lower>(std::forward<T>(t)));
+            if constexpr(B)
+                s << fmp::quoted(v);
+            else
+                s >> fmp::quoted(v);
+        };
 
-        if constexpr(lower + 1 != upper)
-            return apply<B, lower + 1, upper>(s, std::forward<T>(t));
-        else
-            return s;
+        [&]<size_t... N>(std::index_sequence<N...>)
+        {
+            (..., field(fmp::get<lower + N>(std::forward<T>(t)), lower + N == 0));
+        }
+        (std::make_index_sequence<upper - lower>());
+
+        return s;
     }
 
     template <typename S, typename T>
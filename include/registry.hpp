@@ -0,0 +1,253 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+#ifndef REGISTRY_HPP
+#define REGISTRY_HPP
+
+#include <bit>
+#include <array>
+#include <variant>
+#include <algorithm>
+#include <reflect.hpp>
+
+namespace fmp
+{
+    // the id of a message type on the wire, the hash of its name, specialize it to pin explicit ids
+
+    template <typename T>
+    consteval uint64_t type_id()
+    {
+        return hash(type_name_v<T>);
+    }
+
+    template <typename T>
+    inline constexpr auto type_id_v = type_id<T>();
+
+    // a set of message types, a message is its type id followed by the message, a decoded id is mapped
+    // to its type by a perfect hash found at compile time, a multiplicative hash whose top bits give a
+    // distinct slot to every id, so the dispatch is a multiplication, a shift, two loads and an indirect
+    // call however many types there are
+
+    template <typename... Ts>
+    struct registry
+    {
+        static constexpr size_t size = sizeof...(Ts);
+
+        static_assert(size > 0 && size < 65535, "a registry takes 1 to 65534 types");
+
+        static constexpr std::array<uint64_t, size> ids { type_id_v<Ts>... };
+
+        static constexpr bool distinct = []
+        {
+            auto s = ids;
+            std::sort(s.begin(), s.end());
+
+            return std::adjacent_find(s.begin(), s.end()) == s.end();
+        }();
+
+        static_assert(distinct, "the type ids of a registry must be distinct");
+
+        using variant = std::variant<Ts...>;
+
+        static consteval auto layout()
+        {
+            // no multiplier separates equal ids, the layout of such a registry is left to the assertion
+
+            for (size_t bits = std::bit_width(size); distinct; ++bits)
+            {
+                 for (uint64_t k = 0; k != 256; ++k)
+                 {
+                      uint64_t mul = mix(k, 0x9e3779b97f4a7c15) | 1;
+                      std::array<uint64_t, size> s;
+
+                      for (size_t i = 0; i != size; ++i)
+                           s[i] = ids[i] * mul >> (64 - bits);
+
+                      std::sort(s.begin(), s.end());
+
+                      if (std::adjacent_find(s.begin(), s.end()) == s.end())
+                          return std::pair(mul, bits);
+                 }
+            }
+
+            return std::pair(uint64_t(1), size_t(std::bit_width(size)));
+        }
+
+        static constexpr uint64_t mul = layout().first;
+        static constexpr size_t bits = layout().second;
+
+        // the index of every slot, size for the empty ones
+
+        static constexpr auto slots = []
+        {
+            std::array<uint16_t, size_t(1) << bits> s;
+            s.fill(size);
+
+            for (size_t i = 0; i != size; ++i)
+                 s[ids[i] * mul >> (64 - bits)] = i;
+
+            return s;
+        }();
+
+        static constexpr size_t index(uint64_t id) noexcept
+        {
+            size_t i = slots[id * mul >> (64 - bits)];
+
+            return i != size && ids[i] == id ? i : npos;
+        }
+
+        template <typename T>
+        static constexpr size_t index_v = index(type_id_v<std::remove_cvref_t<T>>);
+
+        template <typename S, typename T, typename P>
+        requires is_policy_v<P>
+        static constexpr decltype(auto) marshal(S&& s, T&& t, P&& p)
+        {
+            static_assert(index_v<T> != npos, "the type is not registered");
+
+            uint64_t id = type_id_v<std::remove_cvref_t<T>>;
+            size_t l = s.size();
+
+            assigner<1, std::remove_reference_t<P>> a { p };
+
+            a.template replicate<1>(l, s, id);
+            l = s.size();
+
+            return a.template process<1>(l, std::forward<S>(s), std::forward<T>(t));
+        }
+
+        template <typename S, typename T>
+        requires (!is_policy_v<T>)
+        static constexpr decltype(auto) marshal(S&& s, T&& t)
+        {
+            return marshal(std::forward<S>(s), std::forward<T>(t), policy());
+        }
+
+        template <typename T>
+        static constexpr decltype(auto) marshal(T&& t)
+        {
+            std::string s;
+            marshal(s, std::forward<T>(t));
+
+            return s;
+        }
+
+        // the type id of the message at l, l is left on it
+
+        template <typename S, typename P>
+        static constexpr uint64_t peek(size_t l, S&& s, P&& p)
+        {
+            uint64_t id = 0;
+            assigner<1, std::remove_reference_t<P>>{p}.template replicate<0>(l, s, id);
+
+            return id;
+        }
+
+        template <size_t N, typename S, typename F, typename P>
+        static void invoke(size_t& l, S& s, F& f, P& p)
+        {
+            std::variant_alternative_t<N, variant> t {};
+
+            unmarshal(l, s, t, p);
+            f(t);
+        }
+
+        template <size_t N, typename S, typename P>
+        static void emplace(size_t& l, S& s, variant& v, P& p)
+        {
+            std::variant_alternative_t<N, variant>* t = nullptr;
+
+            if constexpr(requires { requires std::remove_cvref_t<P>::recycle; })
+                t = std::get_if<N>(&v);
+
+            if (!t)
+                t = &v.template emplace<N>();
+
+            unmarshal(l, s, *t, p);
+        }
+
+        // unmarshal the message at l and invoke f with it, return false for an unregistered type, whose
+        // message is left unread past its id
+
+        template <typename S, typename F, typename P>
+        requires is_policy_v<P>
+        static constexpr bool dispatch(size_t& l, S&& s, F&& f, P&& p)
+        {
+            constexpr auto table = []<size_t... N>(std::index_sequence<N...>)
+            {
+                return std::array{ &invoke<N, S, F, P>... };
+            }
+            (std::make_index_sequence<size>());
+
+            size_t i = index(peek(l, s, p));
+            l += sizeof(uint64_t);
+
+            if (i == npos)
+                return false;
+
+            table[i](l, s, f, p);
+
+            return true;
+        }
+
+        template <typename S, typename F>
+        static constexpr bool dispatch(size_t& l, S&& s, F&& f)
+        {
+            return dispatch(l, s, f, policy());
+        }
+
+        template <typename S, typename F>
+        static constexpr bool dispatch(S&& s, F&& f)
+        {
+            size_t l = 0;
+
+            return dispatch(l, s, f);
+        }
+
+        // unmarshal the message at l into the alternative of v of its type, a fresh one, or under reuse
+        // the one held already, so v can be visited and reused without a heap allocation
+
+        template <typename S, typename P>
+        requires is_policy_v<P>
+        static constexpr bool decode(size_t& l, S&& s, variant& v, P&& p)
+        {
+            constexpr auto table = []<size_t... N>(std::index_sequence<N...>)
+            {
+                return std::array{ &emplace<N, S, P>... };
+            }
+            (std::make_index_sequence<size>());
+
+            size_t i = index(peek(l, s, p));
+            l += sizeof(uint64_t);
+
+            if (i == npos)
+                return false;
+
+            table[i](l, s, v, p);
+
+            return true;
+        }
+
+        template <typename S>
+        static constexpr bool decode(size_t& l, S&& s, variant& v)
+        {
+            return decode(l, s, v, policy());
+        }
+
+        template <typename S>
+        static constexpr bool decode(S&& s, variant& v)
+        {
+            size_t l = 0;
+
+            return decode(l, s, v);
+        }
+    };
+}
+
+#endif
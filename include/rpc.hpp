@@ -0,0 +1,384 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+#ifndef RPC_HPP
+#define RPC_HPP
+
+#include <array>
+#include <cerrno>
+#include <string>
+#include <cstring>
+#include <optional>
+#include <unordered_map>
+#include <sys/un.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <reflect.hpp>
+
+namespace fmp::rpc
+{
+    // the id of a method, the hash of the name of its handler, so both ends agree on it at compile time
+
+    template <auto f>
+    inline constexpr uint64_t method_v = hash(invocable_name_v<f>);
+
+    // a frame is [length:u32][id:u64][method:u64][payload], the length counts the bytes after itself
+
+    inline constexpr size_t header_size = sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+    // a connected pair of unix domain sockets, -1 in both on failure
+
+    inline std::array<int, 2> pair()
+    {
+        std::array<int, 2> fds { -1, -1 };
+
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()) < 0)
+            fds = { -1, -1 };
+
+        return fds;
+    }
+
+    inline bool address(const std::string& path, sockaddr_un& addr)
+    {
+        addr = {};
+        addr.sun_family = AF_UNIX;
+
+        if (path.size() >= sizeof(addr.sun_path))
+            return false;
+
+        std::memcpy(addr.sun_path, path.data(), path.size());
+
+        return true;
+    }
+
+    // a socket listening on path, which is replaced if it exists, -1 on failure
+
+    inline int listen(const std::string& path, int backlog = 16)
+    {
+        sockaddr_un addr;
+
+        if (!address(path, addr))
+            return -1;
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (fd < 0)
+            return -1;
+
+        ::unlink(path.c_str());
+
+        if (::bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || ::listen(fd, backlog) < 0)
+        {
+            ::close(fd);
+
+            return -1;
+        }
+
+        return fd;
+    }
+
+    inline int accept(int fd)
+    {
+        int c;
+
+        do
+            c = ::accept(fd, nullptr, nullptr);
+        while (c < 0 && errno == EINTR);
+
+        return c;
+    }
+
+    inline int connect(const std::string& path)
+    {
+        sockaddr_un addr;
+
+        if (!address(path, addr))
+            return -1;
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (fd < 0)
+            return -1;
+
+        if (::connect(fd, (sockaddr*)&addr, sizeof(addr)) < 0)
+        {
+            ::close(fd);
+
+            return -1;
+        }
+
+        return fd;
+    }
+
+    // the framing shared by both ends, frames are marshaled back to back into one buffer and go out
+    // with a single send when flushed, the frames read are unmarshaled in place from the read buffer,
+    // under reuse, so an object taken into again keeps no entries of the previous frame
+
+    struct channel
+    {
+        static constexpr size_t chunk = 1 << 16;
+
+        explicit channel(int fd) : fd(fd)
+        {
+        }
+
+        channel(const channel&) = delete;
+        channel& operator=(const channel&) = delete;
+
+        ~channel()
+        {
+            if (fd >= 0)
+                ::close(fd);
+        }
+
+        // false when a flush of a full buffer fails
+
+        template <typename T>
+        bool put(uint64_t id, uint64_t method, const T& t)
+        {
+            size_t k = out.size();
+            out.append(header_size, '\0');
+
+            marshal(out, t);
+
+            uint32_t length = out.size() - k - sizeof(length);
+
+            std::memcpy(out.data() + k, &length, sizeof(length));
+            std::memcpy(out.data() + k + sizeof(length), &id, sizeof(id));
+            std::memcpy(out.data() + k + sizeof(length) + sizeof(id), &method, sizeof(method));
+
+            return out.size() < chunk || flush();
+        }
+
+        bool flush()
+        {
+            for (size_t k = 0; k != out.size(); )
+            {
+                 ssize_t n = ::send(fd, out.data() + k, out.size() - k, MSG_NOSIGNAL);
+                 ++syscalls;
+
+                 if (n < 0 && errno == EINTR)
+                     continue;
+
+                 if (n <= 0)
+                     return false;
+
+                 k += n;
+            }
+
+            out.clear();
+
+            return true;
+        }
+
+        // read what the socket has, at most chunk bytes, blocking until there is some
+
+        bool fill()
+        {
+            if (pos == in.size())
+            {
+                in.clear();
+                pos = 0;
+            }
+            else if (pos >= chunk)
+            {
+                in.erase(0, pos);
+                pos = 0;
+            }
+
+            ssize_t n = 0;
+
+            in.resize_and_overwrite(in.size() + chunk, [&](char* data, size_t size)
+            {
+                do
+                {
+                    n = ::recv(fd, data + size - chunk, chunk, 0);
+                    ++syscalls;
+                }
+                while (n < 0 && errno == EINTR);
+
+                return size - chunk + std::max<ssize_t>(n, 0);
+            });
+
+            return n > 0;
+        }
+
+        // whether a whole frame is buffered
+
+        bool ready() const
+        {
+            if (in.size() - pos < header_size)
+                return false;
+
+            uint32_t length;
+            std::memcpy(&length, in.data() + pos, sizeof(length));
+
+            return in.size() - pos - sizeof(length) >= length;
+        }
+
+        // take the next buffered frame into t, false when there is none, a frame shorter than its header
+        // or whose payload does not end with it breaks the connection
+
+        template <typename T>
+        bool take(uint64_t& id, uint64_t& method, T& t)
+        {
+            if (broken || !ready())
+                return false;
+
+            uint32_t length;
+
+            std::memcpy(&length, in.data() + pos, sizeof(length));
+            std::memcpy(&id, in.data() + pos + sizeof(length), sizeof(id));
+            std::memcpy(&method, in.data() + pos + sizeof(length) + sizeof(id), sizeof(method));
+
+            size_t end = pos + sizeof(length) + length;
+
+            broken = length < header_size - sizeof(length);
+
+            if (broken)
+                return false;
+
+            size_t l = pos + header_size;
+            unmarshal(l, std::string_view(in).substr(0, end), t, reuse());
+
+            broken = l != end;
+            pos = end;
+
+            return !broken;
+        }
+
+        // the next frame, reading from the socket until one is whole, false on a closed connection
+
+        template <typename T>
+        bool get(uint64_t& id, uint64_t& method, T& t)
+        {
+            while (!take(id, method, t))
+            {
+                if (broken || !fill())
+                    return false;
+            }
+
+            return true;
+        }
+
+        int fd;
+
+        std::string in;
+        std::string out;
+
+        size_t pos = 0;
+        size_t syscalls = 0;
+
+        bool broken = false;
+    };
+
+    // the server end, a request is dispatched to the handler bound to its method and answered under
+    // its id, the requests that arrive together are answered together with a single send
+
+    template <typename Req, typename Resp>
+    struct server : channel
+    {
+        using handler = Resp (*)(const Req&);
+
+        using channel::channel;
+
+        template <auto f>
+        void bind()
+        {
+            handlers[method_v<f>] = f;
+        }
+
+        // serve the requests of one read, false on a closed connection
+
+        bool poll()
+        {
+            if (!fill())
+                return false;
+
+            uint64_t id;
+            uint64_t method;
+
+            while (take(id, method, req))
+            {
+                 auto it = handlers.find(method);
+
+                 if (!(it != handlers.end() ? put(id, method, it->second(req)) : put(id, 0, Resp())))
+                     return false;
+            }
+
+            return !broken && flush();
+        }
+
+        void run()
+        {
+            while (poll());
+        }
+
+        Req req {};
+        std::unordered_map<uint64_t, handler> handlers;
+    };
+
+    // the client end, requests are queued by send and pipelined, the responses come in the order of
+    // the requests, a response of an unbound method has handled cleared
+
+    template <typename Req, typename Resp>
+    struct client : channel
+    {
+        using channel::channel;
+
+        // the id of the request, 0 when the connection is broken
+
+        template <auto f>
+        uint64_t send(const Req& r)
+        {
+            ++last;
+
+            return put(last, method_v<f>, r) ? last : 0;
+        }
+
+        bool recv(uint64_t& id, Resp& r)
+        {
+            uint64_t method;
+
+            if (!get(id, method, r))
+                return false;
+
+            handled = method;
+
+            return true;
+        }
+
+        // a round trip, the responses to the requests sent before are dropped, none when the connection
+        // is broken or closed before the response arrives
+
+        template <auto f>
+        std::optional<Resp> call(const Req& r)
+        {
+            uint64_t id = send<f>(r);
+
+            if (!id || !flush())
+                return std::nullopt;
+
+            std::optional<Resp> resp(std::in_place);
+
+            for (uint64_t k = 0; k != id; )
+            {
+                 if (!recv(k, *resp))
+                     return std::nullopt;
+            }
+
+            return resp;
+        }
+
+        uint64_t last = 0;
+        bool handled = true;
+    };
+}
+
+#endif
@@ -0,0 +1,290 @@
+//
+// Copyright (c) 2024-present DeepGrace (complex dot invoke at gmail dot com)
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+//
+// Official repository: https://github.com/deepgrace/fmp
+//
+
+#ifndef TRACKED_HPP
+#define TRACKED_HPP
+
+#include <array>
+#include <utility>
+#include <cstdint>
+#include <diff.hpp>
+
+namespace fmp
+{
+    // a value whose members are written through proxies that mark them dirty, so that the changes
+    // are marshaled without a previous copy to diff against, marshal_dirty emits a patch of the dirty
+    // members that apply_patch takes on the other side
+
+    template <typename T>
+    struct tracked
+    {
+        static constexpr size_t size = fields_v<T>;
+
+        template <size_t N>
+        struct proxy
+        {
+            using type = std::remove_cvref_t<decltype(fmp::get<N>(fields(std::declval<T&>())))>;
+
+            template <typename U>
+            proxy& operator=(U&& u)
+            {
+                t.template ref<N>() = std::forward<U>(u);
+
+                return *this;
+            }
+
+            proxy& operator=(const proxy& p)
+            {
+                return *this = static_cast<const type&>(p);
+            }
+
+            // compound assignments, increments and decrements mark the member dirty as assignments do
+
+            template <typename U>
+            proxy& operator+=(U&& u)
+            {
+                t.template ref<N>() += std::forward<U>(u);
+
+                return *this;
+            }
+
+            template <typename U>
+            proxy& operator-=(U&& u)
+            {
+                t.template ref<N>() -= std::forward<U>(u);
+
+                return *this;
+            }
+
+            template <typename U>
+            proxy& operator*=(U&& u)
+            {
+                t.template ref<N>() *= std::forward<U>(u);
+
+                return *this;
+            }
+
+            template <typename U>
+            proxy& operator/=(U&& u)
+            {
+                t.template ref<N>() /= std::forward<U>(u);
+
+                return *this;
+            }
+
+            template <typename U>
+            proxy& operator%=(U&& u)
+            {
+                t.template ref<N>() %= std::forward<U>(u);
+
+                return *this;
+            }
+
+            template <typename U>
+            proxy& operator&=(U&& u)
+            {
+                t.template ref<N>() &= std::forward<U>(u);
+
+                return *this;
+            }
+
+            template <typename U>
+            proxy& operator|=(U&& u)
+            {
+                t.template ref<N>() |= std::forward<U>(u);
+
+                return *this;
+            }
+
+            template <typename U>
+            proxy& operator^=(U&& u)
+            {
+                t.template ref<N>() ^= std::forward<U>(u);
+
+                return *this;
+            }
+
+            template <typename U>
+            proxy& operator<<=(U&& u)
+            {
+                t.template ref<N>() <<= std::forward<U>(u);
+
+                return *this;
+            }
+
+            template <typename U>
+            proxy& operator>>=(U&& u)
+            {
+                t.template ref<N>() >>= std::forward<U>(u);
+
+                return *this;
+            }
+
+            proxy& operator++()
+            {
+                ++t.template ref<N>();
+
+                return *this;
+            }
+
+            proxy& operator--()
+            {
+                --t.template ref<N>();
+
+                return *this;
+            }
+
+            type operator++(int)
+            {
+                return t.template ref<N>()++;
+            }
+
+            type operator--(int)
+            {
+                return t.template ref<N>()--;
+            }
+
+            operator const type&() const
+            {
+                return std::as_const(t).template get<N>();
+            }
+
+            // modify the member in place, it is marked dirty whether it changes or not
+
+            type* operator->()
+            {
+                return &t.template ref<N>();
+            }
+
+            tracked& t;
+        };
+
+        tracked() = default;
+
+        explicit tracked(T t) : value(std::move(t))
+        {
+        }
+
+        // the N-th member, N may be given by name as member_index<T>("name")
+
+        template <size_t N>
+        proxy<N> get()
+        {
+            return { *this };
+        }
+
+        template <size_t N>
+        const auto& get() const
+        {
+            return fmp::get<N>(fields(value));
+        }
+
+        template <size_t N>
+        auto& ref()
+        {
+            mark(N);
+
+            return fmp::get<N>(fields(value));
+        }
+
+        void mark(size_t i)
+        {
+            mask[i / 8] |= 1 << i % 8;
+        }
+
+        bool dirty(size_t i) const
+        {
+            return mask[i / 8] >> i % 8 & 1;
+        }
+
+        bool dirty() const
+        {
+            for (auto m : mask)
+            {
+                 if (m)
+                     return true;
+            }
+
+            return false;
+        }
+
+        void clear()
+        {
+            mask = {};
+        }
+
+        const T& operator*() const noexcept
+        {
+            return value;
+        }
+
+        const T* operator->() const noexcept
+        {
+            return &value;
+        }
+
+        // append the patch of the dirty members to s, the record members are patched whole, the marks
+        // stay until clear is called, so that a patch failed to send can be made again
+
+        template <typename S, typename P>
+        requires is_policy_v<P>
+        decltype(auto) marshal_dirty(S&& s, P&& p) const
+        {
+            s.append(reinterpret_cast<const char*>(mask.data()), mask.size());
+
+            fmp::for_each([&, i = size_t(0)]<typename V>(const V& v) mutable
+            {
+                if (dirty(i))
+                {
+                    if constexpr(is_record_v<V>)
+                        overwrite(s, v, p);
+                    else
+                    {
+                        size_t l = s.size();
+                        assigner<1, std::remove_reference_t<P>>{p}.template replicate<1>(l, s, v);
+                    }
+                }
+
+                ++i;
+            }, fields(value));
+
+            return std::forward<S>(s);
+        }
+
+        template <typename S>
+        decltype(auto) marshal_dirty(S&& s) const
+        {
+            return marshal_dirty(std::forward<S>(s), policy());
+        }
+
+        std::string marshal_dirty() const
+        {
+            std::string s;
+
+            return marshal_dirty(s);
+        }
+
+        T value;
+        std::array<uint8_t, (size + 7) / 8> mask {};
+    };
+
+    template <size_t N, typename T>
+    constexpr decltype(auto) get(tracked<T>& t)
+    {
+        return t.template get<N>();
+    }
+
+    template <size_t N, typename T>
+    constexpr decltype(auto) get(const tracked<T>& t)
+    {
+        return t.template get<N>();
+    }
+}
+
+#endif
@@ -72,12 +72,9 @@ namespace fmp
             return *reinterpret_cast<pointer_t<N, q>>(reinterpret_cast<pointer_t<N, q, byte_t>>(p) + d);
         }
 
-        template <bool f, bool t, typename U>
-        requires (!is_fuple_v<std::remove_cvref_t<U>>)
-        constexpr decltype(auto) get(U&& u) noexcept
+        template <bool f, bool t, typename... Args>
+        static constexpr decltype(auto) make(Args&... args)
         {
-            auto& [...args] = u;
-
             if constexpr(f)
             {
                 if constexpr(t)
@@ -94,6 +91,15 @@ namespace fmp
             }
         }
 
+        template <bool f, bool t, typename U>
+        requires (!is_fuple_v<std::remove_cvref_t<U>>)
+        constexpr decltype(auto) get(U&& u) noexcept
+        {
+            auto& [...args] = u;
+
+            return make<f, t>(args...);
+        }
+
         static constexpr storage_t s{};
     };
 }